@@ -219,6 +219,10 @@ namespace casadi {
     return fcn_.sz_w();
   }
 
+  size_t Call::codegen_sz_w(const CodeGenerator& g) const {
+    return fcn_->codegen_sz_w(g);
+  }
+
   std::vector<MX> Call::create(const Function& fcn, const std::vector<MX>& arg) {
     return MX::createMultipleOutput(new Call(fcn, arg));
   }
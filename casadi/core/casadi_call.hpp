@@ -169,6 +169,9 @@ namespace casadi {
         \identifier{75} */
     size_t sz_w() const override;
 
+    /** \brief Get required length of w field in generated code */
+    size_t codegen_sz_w(const CodeGenerator& g) const override;
+
     /** \brief Serialize an object without type information
 
         \identifier{76} */
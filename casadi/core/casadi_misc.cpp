@@ -50,6 +50,8 @@
 
 #undef CASADI_NEED_UNISTD
 
+#include <iomanip>
+
 namespace casadi {
 
   int to_int(casadi_int rhs) {
@@ -368,6 +370,17 @@ std::string simple_mkstemps(const std::string& prefix, const std::string& suffix
   }
 
 
+  std::string hash_hex(const std::string& s) {
+    uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : s) {
+      h ^= c;
+      h *= 1099511628211ULL;
+    }
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << h;
+    return ss.str();
+  }
+
   std::vector<bool> boolvec_not(const std::vector<bool> &v) {
     std::vector<bool> ret(v.size());
     std::transform(v.begin(), v.end(), ret.begin(),
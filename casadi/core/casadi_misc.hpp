@@ -423,6 +423,9 @@ private:
   // Create a temporary file
   CASADI_EXPORT std::string temporary_file(const std::string& prefix, const std::string& suffix);
 
+  // Hexadecimal 64-bit FNV-1a hash of a string, the same on all platforms
+  CASADI_EXPORT std::string hash_hex(const std::string& s);
+
   CASADI_EXPORT void normalized_setup(std::istream& stream);
   CASADI_EXPORT void normalized_setup(std::ostream& stream);
 
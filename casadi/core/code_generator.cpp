@@ -29,6 +29,7 @@
 #include "convexify.hpp"
 #include <casadi_runtime_str.h>
 #include <iomanip>
+#include <cctype>
 
 namespace casadi {
 
@@ -44,6 +45,18 @@ namespace casadi {
     this->casadi_real_type = "double";
     this->casadi_int_type = CASADI_INT_TYPE_STR;
     this->codegen_scalars = false;
+    this->reroll = 0;
+    this->split = 0;
+    this->simd = 0;
+    this->mem_pool = 0;
+    this->specialize = 0;
+    this->compress = false;
+    this->mixed_precision = 0;
+    this->mixed_precision_range = {-1, 1};
+    this->mixed_precision_samples = 8;
+    this->incremental = false;
+    this->fuse = false;
+    this->profile = false;
     this->with_header = false;
     this->with_mem = false;
     this->with_export = true;
@@ -79,6 +92,41 @@ namespace casadi {
         this->casadi_int_type = e.second.to_string();
       } else if (e.first=="codegen_scalars") {
         this->codegen_scalars = e.second;
+      } else if (e.first=="reroll") {
+        this->reroll = e.second;
+        casadi_assert(this->reroll>=0, "Option 'reroll' must be non-negative");
+      } else if (e.first=="profile") {
+        this->profile = e.second;
+      } else if (e.first=="simd") {
+        this->simd = e.second;
+        casadi_assert(this->simd>=0, "Option 'simd' must be non-negative");
+      } else if (e.first=="split") {
+        this->split = e.second;
+        casadi_assert(this->split>=0, "Option 'split' must be non-negative");
+      } else if (e.first=="mem_pool") {
+        this->mem_pool = e.second;
+        casadi_assert(this->mem_pool>=0, "Option 'mem_pool' must be non-negative");
+      } else if (e.first=="specialize") {
+        this->specialize = e.second;
+        casadi_assert(this->specialize>=0, "Option 'specialize' must be non-negative");
+      } else if (e.first=="compress") {
+        this->compress = e.second;
+      } else if (e.first=="mixed_precision") {
+        this->mixed_precision = e.second;
+        casadi_assert(this->mixed_precision>=0, "Option 'mixed_precision' must be non-negative");
+      } else if (e.first=="mixed_precision_range") {
+        this->mixed_precision_range = e.second;
+        casadi_assert(this->mixed_precision_range.size()==2
+          && this->mixed_precision_range[0]<=this->mixed_precision_range[1],
+          "Option 'mixed_precision_range' must be a lower and an upper bound");
+      } else if (e.first=="mixed_precision_samples") {
+        this->mixed_precision_samples = e.second;
+        casadi_assert(this->mixed_precision_samples>0,
+          "Option 'mixed_precision_samples' must be positive");
+      } else if (e.first=="incremental") {
+        this->incremental = e.second;
+      } else if (e.first=="fuse") {
+        this->fuse = e.second;
       } else if (e.first=="with_header") {
         this->with_header = e.second;
       } else if (e.first=="with_mem") {
@@ -130,6 +178,9 @@ namespace casadi {
     // Start off without the need for thread-local memory
     needs_mem_ = false;
 
+    // No split-off functions
+    n_parts_ = 0;
+
     // Divide name into base and suffix (if any)
     std::string::size_type dotpos = name.rfind('.');
     if (dotpos==std::string::npos) {
@@ -152,6 +203,21 @@ namespace casadi {
     if (this->main) add_include("stdio.h");
     if (this->verbose_runtime) add_auxiliary(AUX_PRINTF);
 
+    // Profiling
+    if (this->profile) {
+      casadi_assert(!this->split, "Options 'profile' and 'split' cannot be combined");
+      casadi_assert(!this->incremental, "Options 'profile' and 'incremental' cannot be combined");
+      add_include("time.h");
+      add_include("windows.h", false, "_WIN32");
+      for (const char* e : {"prof_clock", "prof_n", "prof_t", "prof_name"}) shorthand(e);
+    }
+
+    // Memory pool: atomic operations, no heap allocated memory
+    if (this->mem_pool) {
+      casadi_assert(!this->with_mem, "Options 'mem_pool' and 'with_mem' cannot be combined");
+      add_include("intrin.h", false, "_MSC_VER");
+    }
+
     // Mex and main need string.h
     if (this->mex || this->main) {
       add_include("string.h");
@@ -225,7 +291,15 @@ namespace casadi {
     for (auto&& e : added_functions_) if (e.f==f) return e.codegen_name;
 
     // Give it a name
-    std::string fname = shorthand("f" + str(added_functions_.size()));
+    casadi_int ind = added_functions_.size();
+    std::string fname = shorthand("f" + str(ind));
+    if (this->split || this->incremental) {
+      // The function and its memory routines may be called from any translation unit
+      for (const char* r : {"", "_incref", "_decref", "_alloc_mem", "_init_mem", "_free_mem",
+          "_checkout", "_release"}) {
+        split_shared_.insert("f" + str(ind) + r);
+      }
+    }
 
     // Add to list of functions
     added_functions_.push_back({f, fname});
@@ -233,18 +307,48 @@ namespace casadi {
     // Generate declarations
     f->codegen_declarations(*this);
 
+    // Declarations are needed by code in other translation units
+    if (this->split || this->incremental) {
+      std::string q = shared_symbol();
+      this->prototypes << q << f->signature(fname) << ";\n";
+      if (f->has_refcount_) {
+        this->prototypes << q << "void " << fname << "_incref(void);\n"
+                         << q << "void " << fname << "_decref(void);\n";
+      }
+      if (!f->codegen_mem_type().empty()) {
+        this->prototypes << q << "int " << fname << "_alloc_mem(void);\n"
+                         << q << "int " << fname << "_init_mem(int mem);\n"
+                         << q << "void " << fname << "_free_mem(int mem);\n"
+                         << q << "int " << fname << "_checkout(void);\n"
+                         << q << "void " << fname << "_release(int mem);\n";
+      }
+    }
+
     // Print to file
-    f->codegen(*this, fname);
+    if (this->profile) {
+      // Wrap the function in timing calls
+      f->codegen(*this, fname + "_body");
+      *this << "static " << f->signature(fname) << " {\n"
+            << "int flag;\n"
+            << "double t0 = casadi_prof_clock();\n"
+            << "flag = " << fname << "_body(arg, res, iw, w, mem);\n"
+            << "casadi_prof_t[" << ind << "] += casadi_prof_clock()-t0;\n"
+            << "casadi_prof_n[" << ind << "]++;\n"
+            << "return flag;\n"
+            << "}\n\n";
+    } else {
+      f->codegen(*this, fname);
+    }
 
     // Codegen reference count functions, if needed
     if (f->has_refcount_) {
       // Increase reference counter
-      *this << "void " << fname << "_incref(void) {\n";
+      *this << shared_symbol() << "void " << fname << "_incref(void) {\n";
       f->codegen_incref(*this);
       *this << "}\n\n";
 
       // Decrease reference counter
-      *this << "void " << fname << "_decref(void) {\n";
+      *this << shared_symbol() << "void " << fname << "_decref(void) {\n";
       f->codegen_decref(*this);
       *this << "}\n\n";
     }
@@ -254,7 +358,7 @@ namespace casadi {
 
     if (fun_needs_mem) {
       // Alloc memory
-      *this << "int " << fname << "_alloc_mem(void) {\n";
+      *this << shared_symbol() << "int " << fname << "_alloc_mem(void) {\n";
       flush(this->body);
       scope_enter();
       f->codegen_alloc_mem(*this);
@@ -262,7 +366,7 @@ namespace casadi {
       *this << "}\n\n";
 
       // Initialize memory
-      *this << "int " << fname << "_init_mem(int mem) {\n";
+      *this << shared_symbol() << "int " << fname << "_init_mem(int mem) {\n";
       flush(this->body);
       scope_enter();
       f->codegen_init_mem(*this);
@@ -270,7 +374,7 @@ namespace casadi {
       *this << "}\n\n";
 
       // Clear memory
-      *this << "void " << fname << "_free_mem(int mem) {\n";
+      *this << shared_symbol() << "void " << fname << "_free_mem(int mem) {\n";
       flush(this->body);
       scope_enter();
       f->codegen_free_mem(*this);
@@ -278,7 +382,7 @@ namespace casadi {
       *this << "}\n\n";
 
       // Checkout
-      *this << "int " << fname << "_checkout(void) {\n";
+      *this << shared_symbol() << "int " << fname << "_checkout(void) {\n";
       flush(this->body);
       scope_enter();
       f->codegen_checkout(*this);
@@ -286,7 +390,7 @@ namespace casadi {
       *this << "}\n\n";
 
       // Clear memory
-      *this << "void " << fname << "_release(int mem) {\n";
+      *this << shared_symbol() << "void " << fname << "_release(int mem) {\n";
       flush(this->body);
       scope_enter();
       f->codegen_release(*this);
@@ -297,10 +401,38 @@ namespace casadi {
 
     // Flush to body
     flush(this->body);
+    split_points_.push_back(this->body.tellp());
+
+    // Functions split off from the function body
+    for (auto&& p : parts_) {
+      this->body << p;
+      split_points_.push_back(this->body.tellp());
+    }
+    parts_.clear();
 
     return fname;
   }
 
+  std::string CodeGenerator::shared_symbol() const {
+    return this->split || this->incremental ? "CASADI_SYMBOL_INTERNAL " : "";
+  }
+
+  std::string CodeGenerator::add_part(const std::string& args) {
+    // Give it a name
+    split_shared_.insert("p" + str(n_parts_));
+    std::string pname = shorthand("p" + str(n_parts_++));
+    std::string sig = shared_symbol() + "int " + pname + "(" + args + ")";
+    this->prototypes << sig << ";\n";
+
+    // Move the buffer to a function definition
+    std::stringstream s;
+    s << sig << " {\n" << this->buffer.str() << "  return 0;\n}\n\n";
+    this->buffer.str("");
+    this->buffer.clear();
+    parts_.push_back(s.str());
+    return pname;
+  }
+
     void CodeGenerator::add(const Function& f, bool with_jac_sparsity) {
     // Add if not already added
     std::string codegen_name = add_dependency(f);
@@ -359,12 +491,11 @@ namespace casadi {
     return ss.str();
   }
 
-  void CodeGenerator::file_open(std::ofstream& f, const std::string& name, bool cpp) {
-    // Open a file for writing
-    f.open(name);
-
+  // Beginning of a generated file
+  static void file_header(std::ostream& f, bool cpp) {
     // Print header
-    f << "/* This file was automatically generated by CasADi " << casadi_version() << ".\n"
+    f << "/* This file was automatically generated by CasADi "
+      << CodeGenerator::casadi_version() << ".\n"
       << " *  It consists of: \n"
       << " *   1) content generated by CasADi runtime: not copyrighted\n"
       << " *   2) template code copied from CasADi source: permissively licensed (MIT-0)\n"
@@ -380,13 +511,24 @@ namespace casadi {
     }
   }
 
-  void CodeGenerator::file_close(std::ofstream& f, bool cpp) {
+  // End of a generated file
+  static void file_footer(std::ostream& f, bool cpp) {
     // C linkage
     if (!cpp) {
       f << "#ifdef __cplusplus\n"
         << "} /* extern \"C\" */\n"
         << "#endif\n";
     }
+  }
+
+  void CodeGenerator::file_open(std::ofstream& f, const std::string& name, bool cpp) {
+    // Open a file for writing
+    f.open(name);
+    file_header(f, cpp);
+  }
+
+  void CodeGenerator::file_close(std::ofstream& f, bool cpp) {
+    file_footer(f, cpp);
 
     // Close file(s)
     f.close();
@@ -438,6 +580,60 @@ namespace casadi {
       << "#endif\n\n";
   }
 
+  // Internal symbols referenced in a piece of code
+  static std::set<std::string> identifiers(const std::string& s) {
+    std::set<std::string> ret;
+    auto is_id = [](char c) { return isalnum(c) || c=='_';};
+    for (std::string::size_type pos=s.find("casadi_"); pos!=std::string::npos;
+        pos=s.find("casadi_", pos+1)) {
+      if (pos>0 && is_id(s[pos-1])) continue;
+      std::string::size_type end = pos;
+      while (end<s.size() && is_id(s[end])) end++;
+      ret.insert(s.substr(pos, end-pos));
+    }
+    return ret;
+  }
+
+  // Functions defined at file scope in a piece of code
+  static std::set<std::string> functions(const std::string& s) {
+    std::set<std::string> ret;
+    auto is_id = [](char c) { return isalnum(c) || c=='_';};
+    std::string line;
+    for (std::stringstream ss(s); std::getline(ss, line); ) {
+      if (line.empty() || !isalpha(line[0]) || line.compare(0, 7, "typedef")==0) continue;
+      std::string::size_type end = line.find('('), begin;
+      if (end==std::string::npos) continue;
+      for (begin=end; begin>0 && is_id(line[begin-1]); --begin) {}
+      if (line.compare(begin, 7, "casadi_")==0) ret.insert(line.substr(begin, end-begin));
+    }
+    return ret;
+  }
+
+  // Auxiliary code without the file scope static data that is not in the used symbols
+  static std::string filter_static(const std::string& aux, const std::set<std::string>& used) {
+    auto is_id = [](char c) { return isalnum(c) || c=='_';};
+    std::stringstream ret;
+    std::string line;
+    for (std::stringstream ss(aux); std::getline(ss, line); ) {
+      if (line.compare(0, 7, "static ")==0 && line.find('(')==std::string::npos) {
+        // The declared symbol precedes the dimension, the initializer or the semicolon
+        std::string::size_type end = line.find_first_of("[=;"), begin;
+        if (end==std::string::npos) end = 0;
+        while (end>0 && line[end-1]==' ') end--;
+        for (begin=end; begin>0 && is_id(line[begin-1]); --begin) {}
+        std::string id = line.substr(begin, end-begin);
+        if (id.compare(0, 7, "casadi_")==0 && !used.count(id)) continue;
+      }
+      ret << line << "\n";
+    }
+    return ret.str();
+  }
+
+  std::set<std::string> CodeGenerator::unit_symbols(const std::string& code) const {
+    // Static data is only referenced from the code of the unit
+    return identifiers(code + filter_static(this->auxiliaries.str(), {}));
+  }
+
   std::string CodeGenerator::generate(const std::string& prefix) {
     // Throw an error if the prefix contains the filename, since since syntax
     // has changed
@@ -448,16 +644,86 @@ namespace casadi {
     // Create c file
     std::ofstream s;
     std::string fullname = prefix + this->name + this->suffix;
-    file_open(s, fullname, this->cpp);
+    split_files.clear();
+    if (this->split || this->incremental) {
+      std::string b = this->body.str();
+
+      // Cut the body at the first allowed position past the size limit
+      size_t start = 0;
+      for (size_t p : split_points_) {
+        if (static_cast<casadi_int>(p-start)<this->split) continue;
+        std::string code = b.substr(start, p-start), fname;
+        // Everything preceding the function definitions is repeated in each file
+        // Only the symbols used, with names local to the unit
+        std::set<std::string> used = unit_symbols(code);
+        std::stringstream u;
+        if (this->incremental) {
+          // File named after the content
+          dump_preamble(u, "_" + hash_hex(code).substr(0, 8), &used);
+          u << code << std::endl;
+          fname = prefix + this->name + "_" + hash_hex(u.str()) + this->suffix;
+          // Unchanged units are not rewritten, but verified before they are reused
+          std::stringstream c, existing;
+          file_header(c, this->cpp);
+          c << u.str();
+          file_footer(c, this->cpp);
+          std::ifstream in(fname);
+          if (in.good()) existing << in.rdbuf();
+          in.close();
+          if (existing.str()!=c.str()) {
+            std::ofstream f(fname);
+            f << c.str();
+          }
+        } else {
+          dump_preamble(u, "_" + str(split_files.size()+1), &used);
+          u << code << std::endl;
+          fname = prefix + this->name + "_" + str(split_files.size()+1) + this->suffix;
+          file_open(s, fname, this->cpp);
+          s << u.str();
+          file_close(s, this->cpp);
+        }
+        split_files.push_back(fname);
+        start = p;
+      }
 
-    // Dump code to file
-    dump(s);
+      // List of the translation units
+      if (this->incremental) {
+        std::string manifest = prefix + this->name + ".manifest";
+        // Remove the units of a previous generation that are no longer used
+        std::ifstream in(manifest);
+        for (std::string f; std::getline(in, f); ) {
+          if (f==this->name + this->suffix) continue;
+          if (std::find(split_files.begin(), split_files.end(), prefix + f)==split_files.end()) {
+            remove((prefix + f).c_str());
+          }
+        }
+        in.close();
+        std::ofstream m(manifest);
+        for (const std::string& f : split_files) m << f.substr(prefix.size()) << "\n";
+        m << this->name + this->suffix << "\n";
+      }
+
+      // The remainder, with the exposed functions and entry points, goes to the main file
+      std::stringstream rest;
+      rest << b.substr(start) << std::endl;
+      if (this->mex) generate_mex(rest);
+      if (this->main) generate_main(rest);
+      std::set<std::string> used = unit_symbols(rest.str());
+      file_open(s, fullname, this->cpp);
+      dump_preamble(s, "", &used);
+      s << rest.str();
+    } else {
+      file_open(s, fullname, this->cpp);
 
-    // Mex entry point
-    if (this->mex) generate_mex(s);
+      // Dump code to file
+      dump(s);
 
-    // Main entry point
-    if (this->main) generate_main(s);
+      // Mex entry point
+      if (this->mex) generate_mex(s);
+
+      // Main entry point
+      if (this->main) generate_main(s);
+    }
 
     // Finalize file
     file_close(s, this->cpp);
@@ -660,7 +926,7 @@ namespace casadi {
       << "  int_T ii, jj, row, col, nnz_col, ind_start_row_index, offset = 0, jj_total = 0;\n"
       << "  const int_T* sp;\n\n"
       << "  /* Allocate buffers for casadi input and output and simulink output */\n"
-      << "  " + CodeGenerator::array("real_T", "w", f->sz_w()+f->nnz_out())
+      << "  " + CodeGenerator::array("real_T", "w", f->codegen_sz_w(*this)+f->nnz_out())
       << "  " + CodeGenerator::array("int_T", "iw", f->sz_iw())
       << "  const real_T* arg[" << f->sz_arg() <<"] = {0};\n"
       << "  real_T* res[" << f->sz_res() << "] = {0};\n"
@@ -784,6 +1050,60 @@ namespace casadi {
   }
 
   void CodeGenerator::dump(std::ostream& s) {
+    dump_preamble(s);
+
+    // Codegen body
+    s << this->body.str();
+
+    // Profiling accessors
+    if (this->profile) dump_profile(s);
+
+    // End with new line
+    s << std::endl;
+  }
+
+  void CodeGenerator::dump_profile(std::ostream& s) {
+    casadi_int n = added_functions_.size();
+    s << "/* Profiling: number of functions */\n"
+      << declare("casadi_int " + this->prefix + "_profile_n(void)") << " {\n"
+      << "  return " << n << ";\n"
+      << "}\n\n";
+    s << "/* Profiling: name, number of calls and time in seconds of function i */\n"
+      << declare("int " + this->prefix + "_profile(casadi_int i, const char** name, "
+                 "casadi_int* n_call, double* t)") << " {\n"
+      << "  if (i<0 || i>=" << n << ") return 1;\n";
+    if (n>0) {
+      s << "  if (name) *name = casadi_prof_name[i];\n"
+        << "  if (n_call) *n_call = casadi_prof_n[i];\n"
+        << "  if (t) *t = casadi_prof_t[i];\n";
+    }
+    s << "  return 0;\n"
+      << "}\n\n";
+    s << "/* Profiling: reset counters */\n"
+      << declare("void " + this->prefix + "_profile_reset(void)") << " {\n";
+    if (n>0) {
+      s << "  casadi_int i;\n"
+        << "  for (i=0; i<" << n << "; ++i) {\n"
+        << "    casadi_prof_n[i] = 0;\n"
+        << "    casadi_prof_t[i] = 0;\n"
+        << "  }\n";
+    }
+    s << "}\n\n";
+  }
+
+  void CodeGenerator::dump_preamble(std::ostream& s, const std::string& unit,
+                                    const std::set<std::string>* used) {
+    // Filter for symbols not used in the translation unit
+    auto skip = [&](const std::string& id) { return used && !used->count(id);};
+
+    // Hide the symbols of an additional translation unit from the library interface
+    auto hidden = [&](bool push) {
+      if (unit.empty()) return;
+      s << "#if defined(__GNUC__) && !defined(_WIN32) && !defined(__CYGWIN__)\n"
+        << "  #pragma GCC visibility " << (push ? "push(hidden)" : "pop") << "\n"
+        << "#endif\n\n";
+    };
+
     // Consistency check
     casadi_assert_dev(current_indent_ == 0);
 
@@ -797,6 +1117,13 @@ namespace casadi {
       << "  #define CASADI_PREFIX(ID) " << this->prefix << "_ ## ID\n"
       << "#endif\n\n";
 
+    // Wall clock for profiling, also with strict ISO C flags
+    if (this->profile) {
+      s << "#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)\n"
+        << "  #define _POSIX_C_SOURCE 199309L\n"
+        << "#endif\n\n";
+    }
+
     s << this->includes.str();
     s << std::endl;
 
@@ -809,8 +1136,21 @@ namespace casadi {
 
     if (needs_mem_) {
       s << "#ifndef CASADI_MAX_NUM_THREADS\n";
-      s << "#define CASADI_MAX_NUM_THREADS 1\n";
+      s << "#define CASADI_MAX_NUM_THREADS " << std::max(this->mem_pool, casadi_int(1)) << "\n";
       s << "#endif\n\n";
+      if (this->mem_pool) {
+        s << "/* Lock-free acquisition of memory pool entries */\n"
+          << "#ifndef casadi_pool_acquire\n"
+          << "#if defined(_MSC_VER)\n"
+          << "#define casadi_pool_acquire(flag) "
+          << "(_InterlockedCompareExchange((volatile long*)(flag), 1, 0)==0)\n"
+          << "#define casadi_pool_release(flag) _InterlockedExchange((volatile long*)(flag), 0)\n"
+          << "#else\n"
+          << "#define casadi_pool_acquire(flag) __sync_bool_compare_and_swap(flag, 0, 1)\n"
+          << "#define casadi_pool_release(flag) __sync_lock_release(flag)\n"
+          << "#endif\n"
+          << "#endif\n\n";
+      }
     }
 
     // casadi/mem after numeric types to define derived types
@@ -823,13 +1163,40 @@ namespace casadi {
     if (!added_shorthands_.empty()) {
       s << "/* Add prefix to internal symbols */\n";
       for (auto&& i : added_shorthands_) {
-        s << "#define " << "casadi_" << i <<  " CASADI_PREFIX(" << i <<  ")\n";
+        if (skip("casadi_" + i)) continue;
+        s << "#define " << "casadi_" << i <<  " CASADI_PREFIX(" << i;
+        // Symbols local to an additional translation unit get unique names
+        if (!split_shared_.count(i)) s << unit;
+        s <<  ")\n";
+      }
+      s << std::endl;
+    }
+
+    // Auxiliary functions without a shorthand would be defined in each translation unit
+    if (!unit.empty()) {
+      for (const std::string& id : functions(this->auxiliaries.str())) {
+        if (added_shorthands_.count(id.substr(7))) continue;
+        s << "#define " << id << " CASADI_PREFIX(" << id.substr(7) << unit << ")\n";
       }
       s << std::endl;
     }
 
     if (this->with_export) generate_export_symbol(s);
 
+    // Functions called from other translation units are not exported from the library
+    if (this->split || this->incremental) {
+      s << "#ifndef CASADI_SYMBOL_INTERNAL\n"
+        << "  #if defined(__GNUC__) && !defined(_WIN32) && !defined(__CYGWIN__)\n"
+        << "    #define CASADI_SYMBOL_INTERNAL __attribute__ ((visibility (\"hidden\")))\n"
+        << "  #else\n"
+        << "    #define CASADI_SYMBOL_INTERNAL\n"
+        << "  #endif\n"
+        << "#endif\n\n";
+    }
+
+    // Nothing defined in the additional translation units is exported
+    hidden(true);
+
     // Check if inf/nan is needed
     for (const auto& d : double_constants_) {
       for (double e : d) {
@@ -839,11 +1206,12 @@ namespace casadi {
     }
 
     // Codegen auxiliary functions
-    s << this->auxiliaries.str();
+    s << (used ? filter_static(this->auxiliaries.str(), *used) : this->auxiliaries.str());
 
     // Print integer constants
     if (!integer_constants_.empty()) {
       for (casadi_int i=0; i<integer_constants_.size(); ++i) {
+        if (skip("casadi_s" + str(i))) continue;
         print_vector(s, "casadi_s" + str(i), integer_constants_[i]);
       }
       s << std::endl;
@@ -852,6 +1220,7 @@ namespace casadi {
     // Print double constants
     if (!double_constants_.empty()) {
       for (casadi_int i=0; i<double_constants_.size(); ++i) {
+        if (skip("casadi_c" + str(i))) continue;
         print_vector(s, "casadi_c" + str(i), double_constants_[i]);
       }
       s << std::endl;
@@ -860,6 +1229,7 @@ namespace casadi {
     // Print char constants
     if (!char_constants_.empty()) {
       for (casadi_int i=0; i<char_constants_.size(); ++i) {
+        if (skip("casadi_b" + str(i))) continue;
         print_vector(s, "casadi_b" + str(i), char_constants_[i]);
       }
       s << std::endl;
@@ -868,6 +1238,7 @@ namespace casadi {
     // Print string constants
     if (!string_constants_.empty()) {
       for (casadi_int i=0; i<string_constants_.size(); ++i) {
+        if (skip("casadi_a" + str(i))) continue;
         print_vector(s, "casadi_a" + str(i), string_constants_[i]);
       }
       s << std::endl;
@@ -893,18 +1264,55 @@ namespace casadi {
 
     // External function declarations
     if (!added_externals_.empty()) {
+      hidden(false);
       s << "/* External functions */\n";
       for (auto&& i : added_externals_) {
         s << i << std::endl;
       }
       s << std::endl << std::endl;
+      hidden(true);
+    }
+
+    // Profiling counters
+    if (this->profile && !added_functions_.empty()) {
+      casadi_int n = added_functions_.size();
+      std::vector<std::string> names;
+      for (auto&& e : added_functions_) names.push_back(e.f.name());
+      s << "/* Profiling */\n"
+        << "static double casadi_prof_clock(void) {\n"
+        << "#ifdef _WIN32\n"
+        << "  LARGE_INTEGER f, t;\n"
+        << "  QueryPerformanceFrequency(&f);\n"
+        << "  QueryPerformanceCounter(&t);\n"
+        << "  return (double)t.QuadPart/(double)f.QuadPart;\n"
+        << "#elif defined(CLOCK_MONOTONIC)\n"
+        << "  struct timespec t;\n"
+        << "  clock_gettime(CLOCK_MONOTONIC, &t);\n"
+        << "  return (double)t.tv_sec + 1e-9*(double)t.tv_nsec;\n"
+        << "#else\n"
+        << "  /* Fallback: processor time of the process, not wall clock time */\n"
+        << "  return (double)clock()/CLOCKS_PER_SEC;\n"
+        << "#endif\n"
+        << "}\n"
+        << "static casadi_int casadi_prof_n[" << n << "];\n"
+        << "static double casadi_prof_t[" << n << "];\n";
+      print_vector(s, "casadi_prof_name", names);
+      s << std::endl;
     }
 
-    // Codegen body
-    s << this->body.str();
-
-    // End with new line
-    s << std::endl;
+    // Function declarations
+    if (this->split || this->incremental) {
+      std::string line;
+      for (std::stringstream ss(this->prototypes.str()); std::getline(ss, line); ) {
+        // The declared function is the identifier preceding the arguments
+        std::string::size_type end = line.find('('), begin;
+        if (end==std::string::npos) end = 0;
+        for (begin=end; begin>0 && (isalnum(line[begin-1]) || line[begin-1]=='_'); --begin) {}
+        if (skip(line.substr(begin, end-begin))) continue;
+        s << line << "\n";
+      }
+      s << std::endl;
+    }
   }
 
   std::string CodeGenerator::work(casadi_int n, casadi_int sz) const {
@@ -1221,6 +1629,27 @@ namespace casadi {
     return shorthand("a" + str(get_constant(v, true)));
   }
 
+  std::vector<casadi_int> CodeGenerator::index_runs(const std::vector<casadi_int>& v) {
+    std::vector<casadi_int> ret;
+    casadi_int n = v.size();
+    for (casadi_int i=0; i<n; ) {
+      // Find the end of the run
+      casadi_int j = i+1;
+      casadi_int stride = 0;
+      if (v[i]<0) {
+        while (j<n && v[j]<0) j++;
+      } else if (j<n && v[j]>=0) {
+        stride = v[j]-v[i];
+        while (j<n && v[j]>=0 && v[j]-v[j-1]==stride) j++;
+      }
+      ret.push_back(v[i]<0 ? -1 : v[i]);
+      ret.push_back(stride);
+      ret.push_back(j-i);
+      i = j;
+    }
+    return ret;
+  }
+
   void CodeGenerator::constant_copy(
       const std::string& name, const std::vector<casadi_int>& v, const std::string& type) {
     std::string ref = constant(v);
@@ -1941,12 +2370,34 @@ namespace casadi {
     return s.str();
   }
 
+  // Reference to a nonzero of a vector given by an expression
+  static std::string nz_ref(const std::string& x, const std::string& k) {
+    bool simple = true;
+    for (char c : x) simple = simple && (isalnum(c) || c=='_');
+    return (simple ? x : "(" + x + ")") + "[" + k + "]";
+  }
+
+  static std::string nz_ref(const std::string& x, casadi_int k) {
+    return nz_ref(x, str(k));
+  }
+
   std::string CodeGenerator::trans(const std::string& x, const Sparsity& sp_x,
                                    const std::string& y, const Sparsity& sp_y,
                                    const std::string& iw) {
+    // Unroll with the sparsity pattern hard-coded
+    if (this->specialize && sp_x.nnz()<=this->specialize) {
+      std::vector<casadi_int> mapping;
+      casadi_assert_dev(sp_x.transpose(mapping)==sp_y);
+      std::stringstream s;
+      for (casadi_int k=0; k<sp_y.nnz(); ++k) {
+        if (k>0) s << "\n";
+        s << nz_ref(y, k) << " = " << nz_ref(x, mapping[k]) << ";";
+      }
+      return s.str();
+    }
     add_auxiliary(CodeGenerator::AUX_TRANS);
     return "casadi_trans(" + x + "," + sparsity(sp_x) + ", "
-            + y + ", " + sparsity(sp_y) + ", " + iw + ")";
+            + y + ", " + sparsity(sp_y) + ", " + iw + ");";
   }
 
   std::string CodeGenerator::declare(std::string s) {
@@ -1969,6 +2420,25 @@ namespace casadi {
     // If sparsity match, simple copy
     if (sp_arg==sp_res) return copy(arg, sp_arg.nnz(), res);
 
+    // Unroll with the sparsity patterns hard-coded
+    if (this->specialize && sp_res.nnz()<=this->specialize) {
+      casadi_assert_dev(sp_arg.size()==sp_res.size());
+      const casadi_int *colind_arg = sp_arg.colind(), *row_arg = sp_arg.row(),
+        *colind_res = sp_res.colind(), *row_res = sp_res.row();
+      std::vector<casadi_int> ind(sp_arg.size1(), -1);
+      std::stringstream s;
+      for (casadi_int c=0; c<sp_res.size2(); ++c) {
+        for (casadi_int k=colind_arg[c]; k<colind_arg[c+1]; ++k) ind[row_arg[k]] = k;
+        for (casadi_int k=colind_res[c]; k<colind_res[c+1]; ++k) {
+          if (k>0) s << "\n";
+          casadi_int el = ind[row_res[k]];
+          s << nz_ref(res, k) << " = " << (el<0 ? "0" : nz_ref(arg, el)) << ";";
+        }
+        for (casadi_int k=colind_arg[c]; k<colind_arg[c+1]; ++k) ind[row_arg[k]] = -1;
+      }
+      return s.str();
+    }
+
     // Create call
     add_auxiliary(AUX_PROJECT);
     std::stringstream s;
@@ -1991,6 +2461,20 @@ namespace casadi {
   std::string
   CodeGenerator::densify(const std::string& arg, const Sparsity& sp_arg,
                         const std::string& res, bool tr) {
+    // Unroll with the sparsity pattern hard-coded
+    if (this->specialize && sp_arg.nnz()<=this->specialize) {
+      const casadi_int *colind = sp_arg.colind(), *row = sp_arg.row();
+      std::stringstream s;
+      s << clear(res, sp_arg.numel());
+      for (casadi_int c=0; c<sp_arg.size2(); ++c) {
+        for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+          casadi_int ind = tr ? c + row[k]*sp_arg.size2() : row[k] + c*sp_arg.size1();
+          s << "\n" << nz_ref(res, ind) << " = " << nz_ref(arg, k) << ";";
+        }
+      }
+      return s.str();
+    }
+
     // Create call
     add_auxiliary(AUX_DENSIFY);
     std::stringstream s;
@@ -2002,6 +2486,20 @@ namespace casadi {
   std::string
   CodeGenerator::sparsify(const std::string& arg, const std::string& res,
                           const Sparsity& sp_res, bool tr) {
+    // Unroll with the sparsity pattern hard-coded
+    if (this->specialize && sp_res.nnz()<=this->specialize) {
+      const casadi_int *colind = sp_res.colind(), *row = sp_res.row();
+      std::stringstream s;
+      for (casadi_int c=0; c<sp_res.size2(); ++c) {
+        for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+          if (k>0) s << "\n";
+          casadi_int ind = tr ? c + row[k]*sp_res.size2() : row[k] + c*sp_res.size1();
+          s << nz_ref(res, k) << " = " << nz_ref(arg, ind) << ";";
+        }
+      }
+      return s.str();
+    }
+
     // Create call
     add_auxiliary(AUX_SPARSIFY);
     std::stringstream s;
@@ -2101,6 +2599,76 @@ namespace casadi {
                                     const std::string& y, const Sparsity& sp_y,
                                     const std::string& z, const Sparsity& sp_z,
                                     const std::string& w, bool tr) {
+    if (this->specialize) {
+      const casadi_int *colind_x = sp_x.colind(), *row_x = sp_x.row(),
+        *colind_y = sp_y.colind(), *row_y = sp_y.row(),
+        *colind_z = sp_z.colind(), *row_z = sp_z.row();
+      // Number of multiplications
+      casadi_int n_mult = 0;
+      if (tr) {
+        for (casadi_int c=0; c<sp_z.size2(); ++c) {
+          for (casadi_int k=colind_z[c]; k<colind_z[c+1]; ++k) {
+            n_mult += colind_x[row_z[k]+1] - colind_x[row_z[k]];
+          }
+        }
+      } else {
+        for (casadi_int k=0; k<sp_y.nnz(); ++k) {
+          n_mult += colind_x[row_y[k]+1] - colind_x[row_y[k]];
+        }
+      }
+      // Unroll with the sparsity patterns hard-coded
+      if (n_mult<=this->specialize) {
+        // Terms added to each nonzero of z, in the order of casadi_mtimes
+        std::vector<std::string> terms(sp_z.nnz());
+        std::vector<casadi_int> ind(tr ? sp_y.size1() : sp_z.size1(), -1);
+        for (casadi_int c=0; c<sp_z.size2(); ++c) {
+          if (tr) {
+            // Nonzeros of the column of y
+            for (casadi_int k=colind_y[c]; k<colind_y[c+1]; ++k) ind[row_y[k]] = k;
+            for (casadi_int k=colind_z[c]; k<colind_z[c+1]; ++k) {
+              for (casadi_int k1=colind_x[row_z[k]]; k1<colind_x[row_z[k]+1]; ++k1) {
+                if (ind[row_x[k1]]<0) continue;
+                terms[k] += " + " + nz_ref(x, k1) + "*" + nz_ref(y, ind[row_x[k1]]);
+              }
+            }
+            for (casadi_int k=colind_y[c]; k<colind_y[c+1]; ++k) ind[row_y[k]] = -1;
+          } else {
+            // Nonzeros of the column of z
+            for (casadi_int k=colind_z[c]; k<colind_z[c+1]; ++k) ind[row_z[k]] = k;
+            for (casadi_int k=colind_y[c]; k<colind_y[c+1]; ++k) {
+              for (casadi_int k1=colind_x[row_y[k]]; k1<colind_x[row_y[k]+1]; ++k1) {
+                if (ind[row_x[k1]]<0) continue;
+                terms[ind[row_x[k1]]] += " + " + nz_ref(x, k1) + "*" + nz_ref(y, k);
+              }
+            }
+            for (casadi_int k=colind_z[c]; k<colind_z[c+1]; ++k) ind[row_z[k]] = -1;
+          }
+        }
+        std::stringstream s;
+        bool first = true;
+        for (casadi_int k=0; k<sp_z.nnz(); ++k) {
+          if (terms[k].empty()) continue;
+          if (!first) s << "\n";
+          first = false;
+          s << nz_ref(z, k) << " = " << nz_ref(z, k) << terms[k] << ";";
+        }
+        return s.str();
+      }
+      // Dense multiplication with contiguous innermost loop
+      if (!tr && sp_x.is_dense() && sp_y.is_dense() && sp_z.is_dense()) {
+        local("i", "casadi_int");
+        local("j", "casadi_int");
+        local("k", "casadi_int");
+        std::stringstream s;
+        s << "for (i=0; i<" << sp_y.size2() << "; ++i) "
+          << "for (k=0; k<" << sp_y.size1() << "; ++k) "
+          << "for (j=0; j<" << sp_x.size1() << "; ++j) "
+          << nz_ref(z, "j+i*" + str(sp_x.size1())) << " += "
+          << nz_ref(x, "j+k*" + str(sp_x.size1())) << "*"
+          << nz_ref(y, "k+i*" + str(sp_y.size1())) << ";";
+        return s.str();
+      }
+    }
     add_auxiliary(AUX_MTIMES);
     return "casadi_mtimes(" + x + ", " + sparsity(sp_x) + ", " + y + ", " + sparsity(sp_y) + ", "
       + z + ", " + sparsity(sp_z) + ", " + w + ", " +  (tr ? "1" : "0") + ");";
@@ -2194,14 +2762,14 @@ namespace casadi {
     }
   }
 
-  std::string CodeGenerator::sx_work(casadi_int i) {
+  std::string CodeGenerator::sx_work(casadi_int i, bool single) {
     if (avoid_stack_) {
       return "w[" + str(i) + "]";
     } else {
       std::string name = "a"+str(i);
 
       // Make sure work vector element has been declared
-      local(name, "casadi_real");
+      local(name, single ? "float" : "casadi_real");
 
       return name;
     }
@@ -2527,7 +3095,7 @@ namespace casadi {
       sz_arg = std::max(sz_arg, f.f.sz_arg());
       sz_res = std::max(sz_res, f.f.sz_res());
       sz_iw = std::max(sz_iw, f.f.sz_iw());
-      sz_w = std::max(sz_w, f.f.sz_w());
+      sz_w = std::max(sz_w, f.f->codegen_sz_w(*this));
     }
   }
 
@@ -73,6 +73,17 @@ namespace casadi {
     /// Add a function dependency
     std::string add_dependency(const Function& f);
 
+    /** \brief Move the buffered code to a separate function
+
+      The function is defined with the arguments args and placed in a part of
+      its own when the code is split across translation units.
+      Returns the name of the function.
+    */
+    std::string add_part(const std::string& args);
+
+    /// Qualifier of functions shared between the translation units of a split generation
+    std::string shared_symbol() const;
+
     /// Add an external function declaration
     void add_external(const std::string& new_external);
 
@@ -125,6 +136,13 @@ namespace casadi {
         return constant(vector_static_cast<casadi_int>(v));
     }
 
+    /** \brief Decompose an index vector into runs of constant stride
+
+     * Returns (start, stride, length) triplets, negative entries forming runs with
+     * start -1 and stride 0
+     */
+    static std::vector<casadi_int> index_runs(const std::vector<casadi_int>& v);
+
     /** \brief Represent an array constant; adding it when new
 
         \identifier{s0} */
@@ -222,7 +240,7 @@ namespace casadi {
     /** \brief Declare a work vector element
 
         \identifier{se} */
-    std::string sx_work(casadi_int i);
+    std::string sx_work(casadi_int i, bool single=false);
 
     /** \brief Specify the default value for a local variable
 
@@ -803,6 +821,17 @@ namespace casadi {
 
   private:
 
+    /* Generate everything that precedes the function definitions, for a translation unit
+     * with a suffix for its local symbols, restricted to the symbols used if given */
+    void dump_preamble(std::ostream& s, const std::string& unit="",
+                       const std::set<std::string>* used=nullptr);
+
+    // Internal symbols referenced by the code of a translation unit
+    std::set<std::string> unit_symbols(const std::string& code) const;
+
+    // Generate the profiling accessors
+    void dump_profile(std::ostream& s);
+
     // Generate casadi_real definition
     void generate_casadi_real(std::ostream &s) const;
 
@@ -884,6 +913,90 @@ namespace casadi {
         \identifier{u9} */
     bool codegen_scalars;
 
+    /** \brief Loop re-rolling
+
+     * Minimum number of repetitions of an instruction block in an SX algorithm
+     * for it to be generated as a loop over index tables, 0 to disable
+     */
+    casadi_int reroll;
+
+    /** \brief Profiling
+
+     * Count the calls and measure the time spent in each generated function,
+     * accessible through <prefix>_profile. Wall clock time, except on platforms
+     * without clock_gettime or QueryPerformanceCounter, where clock() gives the
+     * processor time instead
+     */
+    bool profile;
+
+    /** \brief Batched evaluation of maps
+
+     * Number of instances of a mapped SX function evaluated together, with the work
+     * vector stored as structure of arrays, 0 to evaluate one instance at a time.
+     * At most 8, larger batches are evaluated one instance at a time
+     */
+    casadi_int simd;
+
+    /** \brief Split the generated code
+
+     * Approximate maximum size in bytes of each translation unit written by generate,
+     * 0 to write a single file
+     */
+    casadi_int split;
+
+    /** \brief Fixed-capacity memory pool
+
+     * Number of memory objects allocated statically for each function needing memory,
+     * checked out lock-free by concurrent callers, 0 for the default memory model
+     */
+    casadi_int mem_pool;
+
+    /** \brief Sparsity-specialized kernels
+
+     * Maximum number of scalar operations for which sparse matrix operations are unrolled
+     * with the sparsity pattern hard-coded, 0 to call the generic runtime routines
+     */
+    casadi_int specialize;
+
+    /** \brief Compressed index tables
+
+     * Store nonzero index tables as runs of constant stride when shorter, and relative
+     * to their smallest entry otherwise, so that tables differing by an offset are shared
+     */
+    bool compress;
+
+    /** \brief Mixed precision
+
+     * Absolute tolerance on the output error from storing SX intermediates in single
+     * precision, chosen by a rounding error analysis at sampled inputs, 0 to disable.
+     * The arithmetic is done in casadi_real
+     */
+    double mixed_precision;
+
+    /// Range of the inputs sampled uniformly by the mixed precision analysis
+    std::vector<double> mixed_precision_range;
+
+    /// Number of input points sampled by the mixed precision analysis
+    casadi_int mixed_precision_samples;
+
+    /** \brief Incremental generation
+
+     * Write each dependency to a translation unit named after a hash of its content,
+     * listed in <name>.manifest, so that unchanged units need not be recompiled
+     */
+    bool incremental;
+
+    /** \brief Fusion of calls
+
+     * Replace calls to SX functions with the same arguments in an MX function
+     * by a single call to a function evaluating all outputs, with common subexpressions
+     * eliminated across the functions
+     */
+    bool fuse;
+
+    // Additional source files written by generate when splitting
+    std::vector<std::string> split_files;
+
     // Have a flag for exporting/importing symbols
     bool with_export, with_import;
 
@@ -900,6 +1013,19 @@ namespace casadi {
     std::stringstream header;
     std::stringstream buffer;
 
+    // Declarations of the functions in the body, needed when splitting
+    std::stringstream prototypes;
+
+    // Functions split off from a function body, not yet added to the body
+    std::vector<std::string> parts_;
+    casadi_int n_parts_;
+
+    // Positions in the body where the code may be split
+    std::vector<size_t> split_points_;
+
+    // Shorthands of functions called across translation units
+    std::set<std::string> split_shared_;
+
     // Are we at a new line?
     bool newline_;
 
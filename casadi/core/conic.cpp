@@ -403,7 +403,20 @@ namespace casadi {
         "When false, the corresponding bounds may be equal or different."}},
       {"print_problem",
        {OT_BOOL,
-        "Print a numeric description of the problem"}}
+        "Print a numeric description of the problem"}},
+      {"presolve",
+       {OT_BOOL,
+        "Presolve the problem before passing it to the solver: eliminate fixed variables, "
+        "turn singleton rows into variable bounds, drop redundant rows and equilibrate. "
+        "Problem dimensions are preserved. Default: false"}},
+      {"presolve_scaling",
+       {OT_INT,
+        "Number of Ruiz equilibration iterations in the presolve, 0 disables scaling. "
+        "Default: 10"}},
+      {"presolve_tol",
+       {OT_DOUBLE,
+        "Largest bound violation of the postsolved solution, relative to max(1, |bound|), "
+        "beyond which the solve is reported as failed. Default: 1e-6"}}
      }
   };
 
@@ -412,6 +425,9 @@ namespace casadi {
     FunctionInternal::init(opts);
 
     print_problem_ = false;
+    presolve_ = false;
+    presolve_scaling_ = 10;
+    presolve_tol_ = 1e-6;
 
     // Read options
     for (auto&& op : opts) {
@@ -421,6 +437,12 @@ namespace casadi {
         equality_ = op.second;
       } else if (op.first=="print_problem") {
         print_problem_ = op.second;
+      } else if (op.first=="presolve") {
+        presolve_ = op.second;
+      } else if (op.first=="presolve_scaling") {
+        presolve_scaling_ = op.second;
+      } else if (op.first=="presolve_tol") {
+        presolve_tol_ = op.second;
       }
     }
 
@@ -442,12 +464,20 @@ namespace casadi {
     casadi_assert(np_==0 || psd_support(),
       "Selected solver does not support psd constraints.");
 
+    casadi_assert(!presolve_ || np_==0, "\"presolve\" is not available with psd constraints");
+    casadi_assert(presolve_scaling_>=0, "\"presolve_scaling\" must be non-negative");
+    casadi_assert(presolve_tol_>=0, "\"presolve_tol\" must be non-negative");
+
     set_qp_prob();
   }
 
   /** \brief Initalize memory block */
   int Conic::init_mem(void* mem) const {
     if (ProtoFunction::init_mem(mem)) return 1;
+    auto m = static_cast<ConicMemory*>(mem);
+    m->n_fixed = m->n_singleton_rows = m->n_redundant_rows = 0;
+    m->postsolve_pr = 0;
+    if (presolve_) m->add_stat("presolve");
 
     return 0;
   }
@@ -543,16 +573,262 @@ namespace casadi {
       check_inputs(arg[CONIC_LBX], arg[CONIC_UBX], arg[CONIC_LBA], arg[CONIC_UBA]);
     }
 
+    // Presolve: point the solver to the reduced data and solution buffers
+    const double* arg0[CONIC_NUM_IN];
+    double* res0[CONIC_NUM_OUT];
+    if (presolve_) {
+      std::copy_n(arg, CONIC_NUM_IN, arg0);
+      std::copy_n(res, CONIC_NUM_OUT, res0);
+      auto it = m->fstats.find("presolve");
+      if (it!=m->fstats.end()) it->second.tic();
+      presolve(m, arg0);
+      if (it!=m->fstats.end()) it->second.toc();
+      arg[CONIC_H] = get_ptr(m->pre_h);
+      arg[CONIC_G] = get_ptr(m->pre_g);
+      arg[CONIC_A] = get_ptr(m->pre_a);
+      arg[CONIC_LBX] = get_ptr(m->pre_lbx);
+      arg[CONIC_UBX] = get_ptr(m->pre_ubx);
+      arg[CONIC_LBA] = get_ptr(m->pre_lba);
+      arg[CONIC_UBA] = get_ptr(m->pre_uba);
+      arg[CONIC_X0] = get_ptr(m->pre_x0);
+      arg[CONIC_LAM_X0] = get_ptr(m->pre_lam_x0);
+      arg[CONIC_LAM_A0] = get_ptr(m->pre_lam_a0);
+      res[CONIC_X] = get_ptr(m->pre_x);
+      res[CONIC_COST] = &m->pre_cost;
+      res[CONIC_LAM_A] = get_ptr(m->pre_lam_a);
+      res[CONIC_LAM_X] = get_ptr(m->pre_lam_x);
+    }
+
     setup(mem, arg, res, iw, w);
 
     int ret = solve(arg, res, iw, w, mem);
 
+    // Postsolve: restore the caller's buffers and recover the original solution
+    if (presolve_) {
+      std::copy_n(arg0, CONIC_NUM_IN, arg);
+      std::copy_n(res0, CONIC_NUM_OUT, res);
+      postsolve(m, arg, res);
+    }
+
     if (error_on_fail_ && !m->d_qp.success)
       casadi_error("conic process failed. "
                    "Set 'error_on_fail' option to false to ignore this error.");
     return ret;
   }
 
+  void Conic::presolve(ConicMemory* m, const double** arg) const {
+    const casadi_int *h_colind = H_.colind(), *h_row = H_.row();
+    const casadi_int *a_colind = A_.colind(), *a_row = A_.row();
+    casadi_int i, j, k, r;
+    // Working copies of the problem data, missing inputs take default values
+    auto load = [&](casadi_int ind, std::vector<double>& v, casadi_int n) {
+      v.resize(n);
+      if (arg[ind]) {
+        casadi_copy(arg[ind], n, get_ptr(v));
+      } else {
+        casadi_fill(get_ptr(v), n, get_default_in(ind));
+      }
+    };
+    load(CONIC_H, m->pre_h, H_.nnz());
+    load(CONIC_G, m->pre_g, nx_);
+    load(CONIC_A, m->pre_a, A_.nnz());
+    load(CONIC_LBX, m->pre_lbx, nx_);
+    load(CONIC_UBX, m->pre_ubx, nx_);
+    load(CONIC_LBA, m->pre_lba, na_);
+    load(CONIC_UBA, m->pre_uba, na_);
+    load(CONIC_X0, m->pre_x0, nx_);
+    load(CONIC_LAM_X0, m->pre_lam_x0, nx_);
+    load(CONIC_LAM_A0, m->pre_lam_a0, na_);
+    m->pre_x.resize(nx_);
+    m->pre_lam_x.resize(nx_);
+    m->pre_lam_a.resize(na_);
+    m->pre_dc.assign(nx_, 1);
+    m->pre_dr.assign(na_, 1);
+    m->pre_src_lbx.assign(nx_, -1);
+    m->pre_src_ubx.assign(nx_, -1);
+    m->pre_fixed.assign(nx_, false);
+    m->n_fixed = m->n_singleton_rows = m->n_redundant_rows = 0;
+    double *h = get_ptr(m->pre_h), *g = get_ptr(m->pre_g), *a = get_ptr(m->pre_a);
+    double *lbx = get_ptr(m->pre_lbx), *ubx = get_ptr(m->pre_ubx);
+    double *lba = get_ptr(m->pre_lba), *uba = get_ptr(m->pre_uba);
+    // Rows that may be relaxed, equality hints promise lba==uba to the solver
+    auto may_free = [&](casadi_int r) { return equality_.empty() || !equality_[r]; };
+
+    // Fixed variables: move their contribution into the linear term and the row bounds
+    for (j=0; j<nx_; ++j) {
+      if (lbx[j]!=ubx[j]) continue;
+      double v = lbx[j];
+      m->pre_fixed[j] = true;
+      m->n_fixed++;
+      for (k=a_colind[j]; k<a_colind[j+1]; ++k) {
+        lba[a_row[k]] -= a[k]*v;
+        uba[a_row[k]] -= a[k]*v;
+        a[k] = 0;
+      }
+      for (k=h_colind[j]; k<h_colind[j+1]; ++k) {
+        if (h_row[k]==j) continue;
+        g[h_row[k]] += h[k]*v;
+        h[k] = 0;
+      }
+    }
+    // Off-diagonal entries in the rows of fixed variables
+    for (j=0; j<nx_; ++j) {
+      for (k=h_colind[j]; k<h_colind[j+1]; ++k) {
+        if (h_row[k]!=j && m->pre_fixed[h_row[k]]) h[k] = 0;
+      }
+    }
+
+    // Singleton rows: count the remaining numerical nonzeros per row
+    std::vector<casadi_int> row_nz(na_, 0), row_k(na_, -1), row_col(na_, -1);
+    for (j=0; j<nx_; ++j) {
+      for (k=a_colind[j]; k<a_colind[j+1]; ++k) {
+        if (a[k]==0) continue;
+        r = a_row[k];
+        row_nz[r]++;
+        row_k[r] = k;
+        row_col[r] = j;
+      }
+    }
+    for (r=0; r<na_; ++r) {
+      if (row_nz[r]!=1 || !may_free(r)) continue;
+      j = row_col[r];
+      double ak = a[row_k[r]];
+      double lo = (ak>0 ? lba[r] : uba[r])/ak;
+      double up = (ak>0 ? uba[r] : lba[r])/ak;
+      if (lo>lbx[j]) {
+        lbx[j] = lo;
+        m->pre_src_lbx[j] = r;
+      }
+      if (up<ubx[j]) {
+        ubx[j] = up;
+        m->pre_src_ubx[j] = r;
+      }
+      lba[r] = -inf;
+      uba[r] = inf;
+      m->n_singleton_rows++;
+    }
+
+    // Redundant rows: activity bounds implied by the variable bounds
+    std::vector<double> act_lo(na_, 0), act_up(na_, 0);
+    for (j=0; j<nx_; ++j) {
+      for (k=a_colind[j]; k<a_colind[j+1]; ++k) {
+        if (a[k]==0) continue;
+        r = a_row[k];
+        act_lo[r] += a[k] * (a[k]>0 ? lbx[j] : ubx[j]);
+        act_up[r] += a[k] * (a[k]>0 ? ubx[j] : lbx[j]);
+      }
+    }
+    for (r=0; r<na_; ++r) {
+      if (row_nz[r]<2 || !may_free(r)) continue;
+      if (act_lo[r]>=lba[r] && act_up[r]<=uba[r]) {
+        lba[r] = -inf;
+        uba[r] = inf;
+        m->n_redundant_rows++;
+      }
+    }
+
+    // Ruiz equilibration of the KKT matrix [H A'; A 0]
+    double *dc = get_ptr(m->pre_dc), *dr = get_ptr(m->pre_dr);
+    std::vector<double> col_max(nx_), row_max(na_);
+    for (casadi_int iter=0; iter<presolve_scaling_; ++iter) {
+      casadi_fill(get_ptr(col_max), nx_, 0.);
+      casadi_fill(get_ptr(row_max), na_, 0.);
+      for (j=0; j<nx_; ++j) {
+        for (k=h_colind[j]; k<h_colind[j+1]; ++k) {
+          col_max[j] = fmax(col_max[j], fabs(h[k]));
+        }
+        for (k=a_colind[j]; k<a_colind[j+1]; ++k) {
+          col_max[j] = fmax(col_max[j], fabs(a[k]));
+          row_max[a_row[k]] = fmax(row_max[a_row[k]], fabs(a[k]));
+        }
+      }
+      // Scaling factors for this sweep, integer variables are left unscaled
+      for (j=0; j<nx_; ++j) {
+        bool integer = !discrete_.empty() && discrete_[j];
+        col_max[j] = col_max[j]==0 || integer ? 1 : 1/sqrt(col_max[j]);
+        dc[j] *= col_max[j];
+      }
+      for (r=0; r<na_; ++r) {
+        row_max[r] = row_max[r]==0 ? 1 : 1/sqrt(row_max[r]);
+        dr[r] *= row_max[r];
+      }
+      for (j=0; j<nx_; ++j) {
+        for (k=h_colind[j]; k<h_colind[j+1]; ++k) h[k] *= col_max[h_row[k]]*col_max[j];
+        for (k=a_colind[j]; k<a_colind[j+1]; ++k) a[k] *= row_max[a_row[k]]*col_max[j];
+      }
+    }
+    if (presolve_scaling_>0) {
+      for (i=0; i<nx_; ++i) {
+        g[i] *= dc[i];
+        lbx[i] /= dc[i];
+        ubx[i] /= dc[i];
+        m->pre_x0[i] /= dc[i];
+        m->pre_lam_x0[i] *= dc[i];
+      }
+      for (r=0; r<na_; ++r) {
+        lba[r] *= dr[r];
+        uba[r] *= dr[r];
+        m->pre_lam_a0[r] /= dr[r];
+      }
+    }
+  }
+
+  void Conic::postsolve(ConicMemory* m, const double** arg, double** res) const {
+    const casadi_int *a_colind = A_.colind(), *a_row = A_.row();
+    casadi_int j, k, r;
+    double *x = get_ptr(m->pre_x), *lam_x = get_ptr(m->pre_lam_x);
+    double *lam_a = get_ptr(m->pre_lam_a);
+    // Undo the scaling
+    for (j=0; j<nx_; ++j) {
+      x[j] *= m->pre_dc[j];
+      lam_x[j] /= m->pre_dc[j];
+    }
+    for (r=0; r<na_; ++r) lam_a[r] *= m->pre_dr[r];
+    // Hand bound multipliers back to the singleton rows that supplied the bound
+    for (j=0; j<nx_; ++j) {
+      r = lam_x[j]>0 ? m->pre_src_ubx[j] : lam_x[j]<0 ? m->pre_src_lbx[j] : -1;
+      if (r<0) continue;
+      for (k=a_colind[j]; k<a_colind[j+1]; ++k) {
+        if (a_row[k]==r) break;
+      }
+      lam_a[r] = lam_x[j]/arg[CONIC_A][k];
+      lam_x[j] = 0;
+    }
+    // Multipliers of fixed variables from stationarity of the original problem
+    if (m->n_fixed>0) {
+      std::vector<double> grad(nx_, 0);
+      if (arg[CONIC_G]) casadi_copy(arg[CONIC_G], nx_, get_ptr(grad));
+      if (arg[CONIC_H]) casadi_mv(arg[CONIC_H], H_, x, get_ptr(grad), 0);
+      if (arg[CONIC_A]) casadi_mv(arg[CONIC_A], A_, lam_a, get_ptr(grad), 1);
+      for (j=0; j<nx_; ++j) {
+        if (m->pre_fixed[j]) lam_x[j] = -grad[j];
+      }
+    }
+    // Objective of the original problem
+    if (res[CONIC_COST]) {
+      double cost = 0;
+      if (arg[CONIC_H]) cost += 0.5*casadi_bilin(arg[CONIC_H], H_, x, x);
+      if (arg[CONIC_G]) cost += casadi_dot(nx_, arg[CONIC_G], x);
+      *res[CONIC_COST] = cost;
+    }
+    casadi_copy(x, nx_, res[CONIC_X]);
+    casadi_copy(lam_x, nx_, res[CONIC_LAM_X]);
+    casadi_copy(lam_a, na_, res[CONIC_LAM_A]);
+    // Bound violation in the original problem, the solver only saw the presolved bounds
+    std::vector<double> ax(na_, 0);
+    if (arg[CONIC_A]) casadi_mv(arg[CONIC_A], A_, x, get_ptr(ax), 0);
+    auto viol = [&](double v, casadi_int lb, casadi_int ub, casadi_int i) {
+      double l = arg[lb] ? arg[lb][i] : get_default_in(lb);
+      double u = arg[ub] ? arg[ub][i] : get_default_in(ub);
+      if (v<l) m->postsolve_pr = fmax(m->postsolve_pr, (l-v)/fmax(1, fabs(l)));
+      if (v>u) m->postsolve_pr = fmax(m->postsolve_pr, (v-u)/fmax(1, fabs(u)));
+    };
+    m->postsolve_pr = 0;
+    for (j=0; j<nx_; ++j) viol(x[j], CONIC_LBX, CONIC_UBX, j);
+    for (r=0; r<na_; ++r) viol(ax[r], CONIC_LBA, CONIC_UBA, r);
+    if (m->postsolve_pr>presolve_tol_) m->d_qp.success = false;
+  }
+
   std::vector<std::string> conic_options(const std::string& name) {
     return Conic::plugin_options(name).all();
   }
@@ -707,6 +983,12 @@ namespace casadi {
     stats["success"] = m->d_qp.success;
     stats["unified_return_status"] = string_from_UnifiedReturnStatus(m->d_qp.unified_return_status);
     stats["iter_count"] = m->d_qp.iter_count;
+    if (presolve_) {
+      stats["n_fixed"] = m->n_fixed;
+      stats["n_singleton_rows"] = m->n_singleton_rows;
+      stats["n_redundant_rows"] = m->n_redundant_rows;
+      stats["postsolve_pr"] = m->postsolve_pr;
+    }
     return stats;
   }
 
@@ -730,10 +1012,13 @@ namespace casadi {
   void Conic::serialize_body(SerializingStream &s) const {
     FunctionInternal::serialize_body(s);
 
-    s.version("Conic", 3);
+    s.version("Conic", 4);
     s.pack("Conic::discrete", discrete_);
     s.pack("Conic::equality", equality_);
     s.pack("Conic::print_problem", print_problem_);
+    s.pack("Conic::presolve", presolve_);
+    s.pack("Conic::presolve_scaling", presolve_scaling_);
+    s.pack("Conic::presolve_tol", presolve_tol_);
     s.pack("Conic::H", H_);
     s.pack("Conic::A", A_);
     s.pack("Conic::Q", Q_);
@@ -753,12 +1038,21 @@ namespace casadi {
   }
 
   Conic::Conic(DeserializingStream & s) : FunctionInternal(s) {
-    int version = s.version("Conic", 1, 3);
+    int version = s.version("Conic", 1, 4);
     s.unpack("Conic::discrete", discrete_);
     if (version>=3) {
       s.unpack("Conic::equality", equality_);
     }
     s.unpack("Conic::print_problem", print_problem_);
+    if (version>=4) {
+      s.unpack("Conic::presolve", presolve_);
+      s.unpack("Conic::presolve_scaling", presolve_scaling_);
+      s.unpack("Conic::presolve_tol", presolve_tol_);
+    } else {
+      presolve_ = false;
+      presolve_scaling_ = 10;
+      presolve_tol_ = 1e-6;
+    }
     if (version==1) {
       s.unpack("Conic::error_on_fail", error_on_fail_);
     }
@@ -779,6 +1073,7 @@ namespace casadi {
   }
 
   void Conic::qp_codegen_body(CodeGenerator& g) const {
+    casadi_assert(!presolve_, "Code generation is not supported with \"presolve\"");
     g.add_auxiliary(CodeGenerator::AUX_QP);
     g.local("d_qp", "struct casadi_qp_data");
     g.local("p_qp", "struct casadi_qp_prob");
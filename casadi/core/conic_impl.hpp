@@ -38,6 +38,22 @@ namespace casadi {
     // Problem data structure
     casadi_qp_data<double> d_qp;
 
+    // Presolved problem data
+    std::vector<double> pre_h, pre_g, pre_a, pre_lbx, pre_ubx, pre_lba, pre_uba,
+      pre_x0, pre_lam_x0, pre_lam_a0;
+    // Solution of the presolved problem
+    std::vector<double> pre_x, pre_lam_x, pre_lam_a;
+    double pre_cost;
+    // Column and row scaling
+    std::vector<double> pre_dc, pre_dr;
+    // Singleton row that supplied a tightened variable bound, -1 if none
+    std::vector<casadi_int> pre_src_lbx, pre_src_ubx;
+    // Variables eliminated as fixed
+    std::vector<bool> pre_fixed;
+    // Presolve statistics
+    casadi_int n_fixed, n_singleton_rows, n_redundant_rows;
+    // Largest bound violation of the postsolved solution
+    double postsolve_pr;
   };
 
   /// Internal class
@@ -105,6 +121,12 @@ namespace casadi {
     void set_work(void* mem, const double**& arg, double**& res,
                           casadi_int*& iw, double*& w) const override;
 
+    /// Reduce the problem data in arg into the presolve buffers of m
+    void presolve(ConicMemory* m, const double** arg) const;
+
+    /// Map the solution of the presolved problem back to the original problem
+    void postsolve(ConicMemory* m, const double** arg, double** res) const;
+
     /// \brief Check if the numerical values of the supplied bounds make sense
     virtual void check_inputs(const double* lbx, const double* ubx,
                              const double* lba, const double* uba) const;
@@ -157,6 +179,9 @@ namespace casadi {
     std::vector<bool> discrete_;
     std::vector<bool> equality_;
     bool print_problem_;
+    bool presolve_;
+    casadi_int presolve_scaling_;
+    double presolve_tol_;
 
     /// Problem structure
     Sparsity H_, A_, Q_, P_;
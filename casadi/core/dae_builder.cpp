@@ -558,7 +558,7 @@ void DaeBuilder::sanity_check() const {
 
 MX DaeBuilder::var(const std::string& name) const {
   try {
-    return variable(name).v;
+    return variable(name).sym();
   } catch (std::exception& e) {
     THROW_ERROR("var", e.what());
     return MX();  // never reached
@@ -31,6 +31,8 @@
 #include <sstream>
 #include <string>
 #include <algorithm>
+#include <fstream>
+#include <iterator>
 
 #include "casadi_misc.hpp"
 #include "exception.hpp"
@@ -40,6 +42,17 @@
 #include "external.hpp"
 #include "fmu_function.hpp"
 #include "integrator.hpp"
+#include "serializing_stream.hpp"
+
+#include <sys/stat.h>
+
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
 
 // Throw informative error message
 #define THROW_ERROR_NODE(FNAME, NODE, WHAT) \
@@ -272,7 +285,7 @@ Initial Variable::default_initial(Causality causality, Variability variability)
 }
 
 Variable::Variable(casadi_int index, casadi_int numel, const std::string& name, const MX& v)
-    : index(index), numel(numel), name(name), v(v) {
+    : index(index), numel(numel), name(name), v(v), has_sym(false) {
   // Default arguments
   dimension = {numel};
   value_reference = index;
@@ -290,6 +303,22 @@ Variable::Variable(casadi_int index, casadi_int numel, const std::string& name,
   dependency = false;
 }
 
+const MX& Variable::sym() const {
+  if (!has_sym) {
+#ifdef CASADI_WITH_THREAD
+    // Shared by all variables, only locked until each symbol exists
+    static std::mutex mtx;
+    std::lock_guard<std::mutex> lock(mtx);
+#endif // CASADI_WITH_THREAD
+    // Variables imported from a model description are created without an expression
+    if (!has_sym) {
+      if (v.is_empty()) v = MX::sym(name, numel);
+      has_sym = true;
+    }
+  }
+  return v;
+}
+
 XmlNode Variable::export_xml(const DaeBuilderInternal& self) const {
   // Create new XmlNode
   XmlNode r;
@@ -372,11 +401,30 @@ DaeBuilderInternal::~DaeBuilderInternal() {
   }
 }
 
+const Options DaeBuilderInternal::options_
+= {{},
+   {{"debug",
+     {OT_BOOL,
+      "Print additional information"}},
+    {"fmutol",
+     {OT_DOUBLE,
+      "Tolerance to use when comparing with the FMU"}},
+    {"description_cache",
+     {OT_STRING,
+      "File in which the parsed model description is stored. "
+      "It is reused as long as the path, size and modification time of the XML file, "
+      "or else its content, are unchanged. Default: no cache"}}
+   }
+};
+
 DaeBuilderInternal::DaeBuilderInternal(const std::string& name, const std::string& path,
     const Dict& opts) : name_(name), path_(path) {
+  // Make sure all options exist
+  options_.check(opts);
   clear_cache_ = false;
   number_of_event_indicators_ = 0;
   provides_directional_derivative_ = 0;
+  can_get_and_set_fmu_state_ = 0;
   symbolic_ = true;
   // Default options
   debug_ = false;
@@ -387,8 +435,8 @@ DaeBuilderInternal::DaeBuilderInternal(const std::string& name, const std::strin
       debug_ = op.second;
     } else if (op.first=="fmutol") {
       fmutol_ = op.second;
-    } else {
-      casadi_error("No such option: " + op.first);
+    } else if (op.first=="description_cache") {
+      description_cache_ = op.second.to_string();
     }
   }
 }
@@ -397,9 +445,13 @@ void DaeBuilderInternal::load_fmi_description(const std::string& filename) {
   // Ensure no variables already
   casadi_assert(n_variables() == 0, "Instance already has variables");
 
-  // Parse XML file
-  XmlFile xml_file("tinyxml");
-  XmlNode fmi_desc = xml_file.parse(filename)[0];  // One child; fmiModelDescription
+  // Parse XML file, take ownership of the single child (fmiModelDescription) without copying
+  XmlNode fmi_desc;
+  {
+    XmlNode doc = read_xml(filename);
+    casadi_assert(doc.size() == 1, "Expected a single root node in " + filename);
+    fmi_desc = std::move(doc.children.front());
+  }
 
   // Read attributes
   fmi_version_ = fmi_desc.attribute<std::string>("fmiVersion", "");
@@ -484,7 +536,7 @@ void DaeBuilderInternal::load_fmi_description(const std::string& filename) {
           v.beq = beq;
           // Also add to list of initial equations
           if (init_eq) {
-            init_lhs_.push_back(v.v);
+            init_lhs_.push_back(v.sym());
             init_rhs_.push_back(beq);
           }
         } catch (std::exception& e) {
@@ -861,13 +913,13 @@ MX DaeBuilderInternal::read_expr(const XmlNode& node) {
     } else if (name=="Cos") {
       return cos(read_expr(node[0]));
     } else if (name=="Der") {
-      return variable(read_variable(node[0]).der_of).v;
+      return variable(read_variable(node[0]).der_of).sym();
     } else if (name=="Div") {
       return read_expr(node[0]) / read_expr(node[1]);
     } else if (name=="Exp") {
       return exp(read_expr(node[0]));
     } else if (name=="Identifier") {
-      return read_variable(node).v;
+      return read_variable(node).sym();
     } else if (name=="IntegerLiteral" || name=="BooleanLiteral") {
       casadi_int val;
       node.get(&val);
@@ -927,7 +979,7 @@ MX DaeBuilderInternal::read_expr(const XmlNode& node) {
     } else if (name=="Time") {
       return var(t_.at(0));
     } else if (name=="TimedVariable") {
-      return read_variable(node[0]).v;
+      return read_variable(node[0]).sym();
     } else if (name=="FunctionCall") {
       // Get the name of the function
       std::string fname = qualified_name(node["exp:Name"]);
@@ -1298,7 +1350,7 @@ void DaeBuilderInternal::tearing_variables(std::vector<std::string>* res,
         r_hold.push_back(false);
       } else {
         any_hold = true;
-        r_hold.push_back(variable(res_hold_name).v);
+        r_hold.push_back(variable(res_hold_name).sym());
         casadi_assert(r_hold.back().is_scalar(), "Non-scalar hold variable for " + res_hold_name);
       }
       if (res) res->push_back(v->name);
@@ -1307,7 +1359,7 @@ void DaeBuilderInternal::tearing_variables(std::vector<std::string>* res,
         iv_hold.push_back(false);
       } else {
         any_hold = true;
-        iv_hold.push_back(variable(iv_hold_name).v);
+        iv_hold.push_back(variable(iv_hold_name).sym());
         casadi_assert(iv_hold.back().is_scalar(), "Non-scalar hold variable for " + iv_hold_name);
       }
       if (iv) iv->push_back(iv_name);
@@ -1444,11 +1496,11 @@ std::string DaeBuilderInternal::qualified_name(const XmlNode& nn) {
 }
 
 const MX& DaeBuilderInternal::var(const std::string& name) const {
-  return variable(name).v;
+  return variable(name).sym();
 }
 
 MX DaeBuilderInternal::der(const std::string& name) const {
-  return variable(variable(name).der_of).v;
+  return variable(variable(name).der_of).sym();
 }
 
 MX DaeBuilderInternal::der(const MX& var) const {
@@ -2261,8 +2313,17 @@ Function DaeBuilderInternal::fmu_fun(const std::string& name,
       casadi_error(std::string("Cannot read 'aux': ") + e.what());
     }
   }
+  // Maximum number of idle FMU instances kept for reuse
+  casadi_int instance_pool_size = 0;
+  if ((it = opts.find("instance_pool_size")) != opts.end()) {
+    try {
+      instance_pool_size = it->second;
+    } catch (std::exception& e) {
+      casadi_error(std::string("Cannot read 'instance_pool_size': ") + e.what());
+    }
+  }
   // New FMU instance (to be shared between derivative functions)
-  Fmu fmu(name, FmuApi::FMI2, this, scheme_in, scheme_out, scheme, aux);
+  Fmu fmu(name, FmuApi::FMI2, this, scheme_in, scheme_out, scheme, aux, instance_pool_size);
 
   // Crete new function
   return Function::create(new FmuFunction(name, fmu, name_in, name_out), opts);
@@ -2475,6 +2536,82 @@ void DaeBuilderInternal::set_alg(const std::string& name, const MX& alg_rhs) {
   }
 }
 
+XmlNode DaeBuilderInternal::read_xml(const std::string& filename) const {
+  // Parse XML file if no cache
+  if (description_cache_.empty()) {
+    XmlFile xml_file("tinyxml");
+    return xml_file.parse(filename);
+  }
+  // Identify the XML file by its path, size and modification time
+  struct stat st;
+  casadi_assert(stat(filename.c_str(), &st) == 0, "Cannot open " + filename);
+  casadi_int xml_size = st.st_size, xml_mtime = st.st_mtime;
+  // Hash of the content, only computed when the file may have changed
+  size_t xml_hash = 0;
+  bool hashed = false;
+  auto content_hash = [&]() {
+    std::ifstream xml(filename, std::ios::binary);
+    casadi_assert(xml.good(), "Cannot open " + filename);
+    std::string content((std::istreambuf_iterator<char>(xml)), std::istreambuf_iterator<char>());
+    hashed = true;
+    return std::hash<std::string>()(content);
+  };
+  // Try to read from cache
+  XmlNode ret;
+  bool found = false;
+  std::ifstream cache_in(description_cache_, std::ios::binary);
+  if (cache_in.good()) {
+    try {
+      DeserializingStream s(cache_in);
+      s.version("XmlCache", 2);
+      std::string cache_path;
+      casadi_int cache_size, cache_mtime;
+      size_t cache_hash;
+      s.unpack("XmlCache::path", cache_path);
+      s.unpack("XmlCache::size", cache_size);
+      s.unpack("XmlCache::mtime", cache_mtime);
+      s.unpack("XmlCache::hash", cache_hash);
+      if (cache_size == xml_size) {
+        if (cache_path == filename && cache_mtime == xml_mtime) {
+          // Unmodified file, no need to read it
+          if (debug_) casadi_message("Reading " + filename + " from " + description_cache_);
+          return XmlNode::deserialize(s);
+        }
+        // Moved or touched file: compare content
+        xml_hash = content_hash();
+        if (cache_hash == xml_hash) {
+          if (debug_) casadi_message("Reading " + filename + " from " + description_cache_);
+          ret = XmlNode::deserialize(s);
+          found = true;
+        }
+      }
+    } catch (std::exception& e) {
+      casadi_warning("Cannot read " + description_cache_ + ": " + std::string(e.what()));
+    }
+  }
+  cache_in.close();
+  if (!found) {
+    // Parse XML file
+    if (!hashed) xml_hash = content_hash();
+    XmlFile xml_file("tinyxml");
+    ret = xml_file.parse(filename);
+  }
+  // Update cache
+  std::ofstream cache_out(description_cache_, std::ios::binary);
+  if (cache_out.good()) {
+    SerializingStream s(cache_out);
+    s.version("XmlCache", 2);
+    s.pack("XmlCache::path", filename);
+    s.pack("XmlCache::size", xml_size);
+    s.pack("XmlCache::mtime", xml_mtime);
+    s.pack("XmlCache::hash", xml_hash);
+    ret.serialize(s);
+  } else {
+    casadi_warning("Cannot write " + description_cache_);
+  }
+  return ret;
+}
+
 template<typename T>
 std::vector<T> read_list(const XmlNode& n) {
   // Number of elements
@@ -2492,6 +2629,8 @@ void DaeBuilderInternal::import_model_exchange(const XmlNode& n) {
   // Read attributes
   provides_directional_derivative_
     = n.attribute<bool>("providesDirectionalDerivative", false);
+  can_get_and_set_fmu_state_
+    = n.attribute<bool>("canGetAndSetFMUstate", false);
   model_identifier_ = n.attribute<std::string>("modelIdentifier");
   // Get list of source files
   if (n.has_child("SourceFiles")) {
@@ -2501,11 +2640,14 @@ void DaeBuilderInternal::import_model_exchange(const XmlNode& n) {
   }
 }
 
-void DaeBuilderInternal::import_model_variables(const XmlNode& modvars) {
+void DaeBuilderInternal::import_model_variables(XmlNode& modvars) {
+  // Preallocate variable table
+  variables_.reserve(variables_.size() + modvars.size());
+  varind_.reserve(varind_.size() + modvars.size());
   // Add variables
   for (casadi_int i = 0; i < modvars.size(); ++i) {
     // Get a reference to the variable
-    const XmlNode& vnode = modvars[i];
+    XmlNode& vnode = modvars[i];
 
     // Name of variable
     std::string name = vnode.attribute<std::string>("name");
@@ -2516,9 +2658,8 @@ void DaeBuilderInternal::import_model_variables(const XmlNode& modvars) {
       continue;
     }
 
-    // Create new variable
+    // Create new variable, symbolic expression created on first use
     Variable& var = new_variable(name);
-    var.v = MX::sym(name);
 
     // Read common attributes, cf. FMI 2.0.2 specification, 2.2.7
     var.value_reference = static_cast<unsigned int>(vnode.attribute<casadi_int>("valueReference"));
@@ -2574,7 +2715,12 @@ void DaeBuilderInternal::import_model_variables(const XmlNode& modvars) {
     } else if (var.variability == Variability::TUNABLE) {
       p_.push_back(var.index);
     }
+    // Release the XML node, no longer needed
+    vnode = XmlNode();
   }
+  // Free memory for the released nodes
+  modvars.children.clear();
+  modvars.children.shrink_to_fit();
   // Handle derivatives
   for (size_t i = 0; i < n_variables(); ++i) {
     if (variable(i).der_of >= 0) {
@@ -2597,7 +2743,7 @@ void DaeBuilderInternal::import_model_structure(const XmlNode& n) {
       // Add to y, unless state
       if (v.der < 0) {
         y_.push_back(v.index);
-        v.beq = v.v;
+        v.beq = v.sym();
       }
       // Get dependencies
       v.dependencies = e.attribute<std::vector<casadi_int>>("dependencies", {});
@@ -2659,7 +2805,7 @@ void DaeBuilderInternal::import_model_structure(const XmlNode& n) {
 }
 
 const MX& DaeBuilderInternal::var(size_t ind) const {
-  return variable(ind).v;
+  return variable(ind).sym();
 }
 
 std::vector<MX> DaeBuilderInternal::var(const std::vector<size_t>& ind) const {
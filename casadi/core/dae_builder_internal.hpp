@@ -27,10 +27,12 @@
 #define CASADI_DAE_BUILDER_INTERNAL_HPP
 
 #include <unordered_map>
+#include <atomic>
 
 #include "dae_builder.hpp"
 #include "shared_object_internal.hpp"
 #include "casadi_enum.hpp"
+#include "options.hpp"
 
 namespace casadi {
 
@@ -130,8 +132,11 @@ struct CASADI_EXPORT Variable {
   /// Dependencies
   mutable std::vector<DependenciesKind> dependenciesKind;
 
-  /// Variable expression
-  MX v;
+  /// Variable expression, empty until first requested via sym()
+  mutable MX v;
+
+  /// Has sym() been called, also for variables without elements
+  mutable std::atomic<bool> has_sym;
 
   /// Binding equation
   MX beq;
@@ -154,6 +159,9 @@ struct CASADI_EXPORT Variable {
   // Export as XML
   XmlNode export_xml(const DaeBuilderInternal& self) const;
 
+  // Symbolic expression, created on first use
+  const MX& sym() const;
+
   // Is the variable real?
   bool is_real() const {return type == Type::FLOAT32 || type == Type::FLOAT64;}
 
@@ -173,6 +181,9 @@ class CASADI_EXPORT DaeBuilderInternal : public SharedObjectInternal {
   /// Constructor
   explicit DaeBuilderInternal(const std::string& name, const std::string& path, const Dict& opts);
 
+  /// Options
+  static const Options options_;
+
   /// Destructor
   ~DaeBuilderInternal() override;
 
@@ -234,6 +245,9 @@ class CASADI_EXPORT DaeBuilderInternal : public SharedObjectInternal {
   /// Import existing problem from FMI/XML
   void load_fmi_description(const std::string& filename);
 
+  /// Parse an XML file, or read the parsed file from the binary cache
+  XmlNode read_xml(const std::string& filename) const;
+
   /// Get current date and time in the ISO 8601 format
   static std::string iso_8601_time();
 
@@ -410,6 +424,7 @@ protected:
   // User-set options
   bool debug_;
   double fmutol_;
+  std::string description_cache_;
 
   // FMI attributes
   std::string fmi_version_;
@@ -427,6 +442,7 @@ protected:
   // Model Exchange
   std::string model_identifier_;
   bool provides_directional_derivative_;
+  bool can_get_and_set_fmu_state_;
   std::vector<std::string> source_files_;
 
   /// Name of instance
@@ -534,7 +550,7 @@ protected:
   void import_model_exchange(const XmlNode& n);
 
   // Read ModelVariables
-  void import_model_variables(const XmlNode& modvars);
+  void import_model_variables(XmlNode& modvars);
 
   // Read ModelStructure
   void import_model_structure(const XmlNode& n);
@@ -0,0 +1,399 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "edge_pushing.hpp"
+#include "serializing_stream.hpp"
+
+namespace casadi {
+
+  EdgePushing::EdgePushing(const std::string& name, const Function& f, casadi_int iind,
+      casadi_int oind, const std::string& triangle, const std::string& name_out)
+      : FunctionInternal(name), f_(f), iind_(iind), oind_(oind), triangle_(triangle),
+        hname_(name_out) {
+    casadi_assert(f_.is_a("SXFunction"),
+      "Edge pushing Hessian requires an SXFunction, got " + f_.class_name());
+    casadi_assert(iind_>=0 && iind_<f_.n_in(), "Input index out of bounds");
+    casadi_assert(oind_>=0 && oind_<f_.n_out(), "Output index out of bounds");
+    casadi_assert(f_.sparsity_out(oind_).is_scalar(true),
+      "Can only take Hessian of scalar expression.");
+    casadi_assert(triangle_=="full" || triangle_=="triu" || triangle_=="tril",
+      "Unknown Hessian part '" + triangle_ + "', expected 'full', 'triu' or 'tril'");
+
+    // Record the tape
+    record();
+
+    // Structural sweep: unit partials, positive throughout, so no cancellation
+    casadi_int n = op_.size();
+    std::vector<double> val(n, 1.), adj(n, 0.);
+    std::vector<std::unordered_map<casadi_int, double> > hes(n);
+    sweep(get_ptr(val), get_ptr(adj), hes, false);
+
+    // Collect the Hessian pattern
+    std::vector<casadi_int> row, col;
+    for (casadi_int k=0; k<n; ++k) {
+      if (op_[k]!=OP_INPUT || in_ind_[k]!=iind_) continue;
+      casadi_int c = lin_[in_nz_[k]];
+      for (auto&& e : hes[k]) {
+        casadi_int r = lin_[in_nz_[e.first]];
+        if (triangle_=="triu" && r>c) continue;
+        if (triangle_=="tril" && r<c) continue;
+        row.push_back(r);
+        col.push_back(c);
+      }
+    }
+    casadi_int nx = f_.numel_in(iind_);
+    sp_ = Sparsity::triplet(nx, nx, row, col);
+  }
+
+  EdgePushing::~EdgePushing() {
+    clear_mem();
+  }
+
+  void EdgePushing::record() {
+    op_.clear();
+    arg0_.clear();
+    arg1_.clear();
+    con_.clear();
+    active_.clear();
+    in_ind_.clear();
+    in_nz_.clear();
+    out_node_ = -1;
+
+    // Tape node currently stored at each work vector element
+    std::vector<casadi_int> node_of;
+    bool d_sp[2], dd_sp[3];
+    casadi_int n_instr = f_.n_instructions();
+    for (casadi_int k=0; k<n_instr; ++k) {
+      casadi_int op = f_.instruction_id(k);
+      std::vector<casadi_int> o = f_.instruction_output(k);
+      std::vector<casadi_int> i = f_.instruction_input(k);
+      if (op==OP_OUTPUT) {
+        if (o[0]==oind_) out_node_ = node_of.at(i[0]);
+        continue;
+      }
+      casadi_int a0 = -1, a1 = -1, ind = -1, nz = -1;
+      double c = 0;
+      bool act = false;
+      if (op==OP_CONST) {
+        c = f_.instruction_constant(k);
+      } else if (op==OP_INPUT) {
+        ind = i[0];
+        nz = i[1];
+        act = ind==iind_;
+      } else {
+        casadi_assert(structure(op, d_sp, dd_sp),
+          "Edge pushing Hessian: operation '" + casadi_math<double>::name(op)
+          + "' not supported");
+        a0 = node_of.at(i[0]);
+        if (casadi_math<double>::ndeps(op)==2) a1 = node_of.at(i[1]);
+        act = active_[a0] || (a1>=0 && active_[a1]);
+      }
+      if (o[0]>=node_of.size()) node_of.resize(o[0]+1, -1);
+      node_of[o[0]] = op_.size();
+      op_.push_back(op);
+      arg0_.push_back(a0);
+      arg1_.push_back(a1);
+      con_.push_back(c);
+      active_.push_back(act);
+      in_ind_.push_back(ind);
+      in_nz_.push_back(nz);
+    }
+
+    // Linear index of each nonzero of the input
+    lin_ = f_.sparsity_in(iind_).find();
+  }
+
+  bool EdgePushing::structure(casadi_int op, bool* d_sp, bool* dd_sp) {
+    d_sp[0] = d_sp[1] = true;
+    dd_sp[0] = dd_sp[1] = dd_sp[2] = false;
+    switch (op) {
+      // Linear
+      case OP_ASSIGN: case OP_ADD: case OP_SUB: case OP_NEG: case OP_TWICE:
+        return true;
+      case OP_LIFT: case OP_PRINTME:
+        d_sp[1] = false;
+        return true;
+      // Piecewise constant
+      case OP_LT: case OP_LE: case OP_EQ: case OP_NE: case OP_NOT: case OP_AND: case OP_OR:
+      case OP_FLOOR: case OP_CEIL: case OP_SIGN:
+        d_sp[0] = d_sp[1] = false;
+        return true;
+      // Piecewise linear
+      case OP_FABS: case OP_FMIN: case OP_FMAX: case OP_COPYSIGN: case OP_FMOD: case OP_REMAINDER:
+        return true;
+      case OP_IF_ELSE_ZERO:
+        d_sp[0] = false;
+        return true;
+      // Bilinear
+      case OP_MUL:
+        dd_sp[1] = true;
+        return true;
+      case OP_DIV:
+        dd_sp[1] = dd_sp[2] = true;
+        return true;
+      case OP_POW: case OP_ATAN2: case OP_HYPOT:
+        dd_sp[0] = dd_sp[1] = dd_sp[2] = true;
+        return true;
+      case OP_CONSTPOW:
+        d_sp[1] = false;
+        dd_sp[0] = true;
+        return true;
+      // Smooth unary
+      case OP_EXP: case OP_LOG: case OP_SQRT: case OP_SQ: case OP_SIN: case OP_COS: case OP_TAN:
+      case OP_ASIN: case OP_ACOS: case OP_ATAN: case OP_INV: case OP_SINH: case OP_COSH:
+      case OP_TANH: case OP_ASINH: case OP_ACOSH: case OP_ATANH: case OP_ERF: case OP_ERFINV:
+      case OP_LOG1P: case OP_EXPM1:
+        dd_sp[0] = true;
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  void EdgePushing::der2(casadi_int op, double x, double y, double f, double* dd) {
+    dd[0] = dd[1] = dd[2] = 0;
+    double t;
+    switch (op) {
+      case OP_MUL: dd[1] = 1; break;
+      case OP_DIV: dd[1] = -1/(y*y); dd[2] = 2*x/(y*y*y); break;
+      case OP_POW:
+        dd[0] = y*(y-1)*pow(x, y-2);
+        dd[1] = pow(x, y-1)*(1+y*log(x));
+        dd[2] = f*log(x)*log(x);
+        break;
+      case OP_CONSTPOW: dd[0] = y*(y-1)*pow(x, y-2); break;
+      case OP_ATAN2:
+        t = x*x+y*y;
+        dd[0] = -2*x*y/(t*t);
+        dd[1] = (x*x-y*y)/(t*t);
+        dd[2] = 2*x*y/(t*t);
+        break;
+      case OP_HYPOT:
+        t = f*f*f;
+        dd[0] = y*y/t;
+        dd[1] = -x*y/t;
+        dd[2] = x*x/t;
+        break;
+      case OP_EXP: dd[0] = f; break;
+      case OP_LOG: dd[0] = -1/(x*x); break;
+      case OP_SQRT: dd[0] = -0.25/(x*f); break;
+      case OP_SQ: dd[0] = 2; break;
+      case OP_SIN: dd[0] = -f; break;
+      case OP_COS: dd[0] = -f; break;
+      case OP_TAN: dd[0] = 2*f*(1+f*f); break;
+      case OP_ASIN: dd[0] = x/pow(1-x*x, 1.5); break;
+      case OP_ACOS: dd[0] = -x/pow(1-x*x, 1.5); break;
+      case OP_ATAN: t = 1+x*x; dd[0] = -2*x/(t*t); break;
+      case OP_INV: dd[0] = 2*f*f*f; break;
+      case OP_SINH: dd[0] = f; break;
+      case OP_COSH: dd[0] = f; break;
+      case OP_TANH: dd[0] = -2*f*(1-f*f); break;
+      case OP_ASINH: dd[0] = -x/pow(1+x*x, 1.5); break;
+      case OP_ACOSH: dd[0] = -x/pow(x*x-1, 1.5); break;
+      case OP_ATANH: t = 1-x*x; dd[0] = 2*x/(t*t); break;
+      case OP_ERF: dd[0] = -4*x/sqrt(pi)*exp(-x*x); break;
+      case OP_ERFINV: t = sqrt(pi)/2*exp(f*f); dd[0] = 2*f*t*t; break;
+      case OP_LOG1P: dd[0] = -1/((1+x)*(1+x)); break;
+      case OP_EXPM1: dd[0] = f+1; break;
+      default: break;
+    }
+  }
+
+  void EdgePushing::sweep(const double* val, double* adj,
+      std::vector<std::unordered_map<casadi_int, double> >& hes, bool numeric) const {
+    casadi_int n = op_.size();
+    casadi_fill(adj, n, 0.);
+    for (auto&& h : hes) h.clear();
+    if (out_node_<0 || !active_[out_node_]) return;
+    adj[out_node_] = 1;
+
+    // Add to a symmetric second order adjoint
+    auto add = [&](casadi_int i, casadi_int j, double v) {
+      if (v==0) return;
+      if (i==j) {
+        hes[i][i] += v;
+      } else {
+        hes[i][j] += v;
+        hes[j][i] += v;
+      }
+    };
+
+    bool d_sp[2], dd_sp[3];
+    double pd[2], pdd[3];
+    casadi_int a[2], s[2];
+    double d[2], dd[2][2];
+    std::unordered_map<casadi_int, double> hk;
+    for (casadi_int k=out_node_; k>=0; --k) {
+      if (!active_[k] || op_[k]==OP_INPUT) continue;
+      if (adj[k]==0 && hes[k].empty()) continue;
+
+      // Partials of the elementary operation
+      casadi_int op = op_[k];
+      structure(op, d_sp, dd_sp);
+      casadi_int ndep = arg1_[k]>=0 ? 2 : 1;
+      if (numeric) {
+        double x = val[arg0_[k]], y = ndep==2 ? val[arg1_[k]] : x;
+        casadi_math<double>::der(op, x, y, val[k], pd);
+        der2(op, x, y, val[k], pdd);
+      } else {
+        pd[0] = pd[1] = pdd[0] = pdd[1] = pdd[2] = 1;
+      }
+      for (casadi_int i=0; i<2; ++i) if (!d_sp[i]) pd[i] = 0;
+      for (casadi_int i=0; i<3; ++i) if (!dd_sp[i]) pdd[i] = 0;
+
+      // Merge repeated arguments, drop arguments not depending on the input
+      casadi_int na = 0;
+      for (casadi_int i=0; i<ndep; ++i) {
+        casadi_int ai = i==0 ? arg0_[k] : arg1_[k];
+        s[i] = -1;
+        if (!active_[ai]) continue;
+        casadi_int j;
+        for (j=0; j<na; ++j) if (a[j]==ai) break;
+        if (j==na) {
+          a[na] = ai;
+          d[na] = 0;
+          dd[na][0] = dd[na][1] = dd[0][na] = dd[1][na] = 0;
+          na++;
+        }
+        s[i] = j;
+        d[j] += pd[i];
+      }
+      for (casadi_int i=0; i<ndep; ++i) {
+        for (casadi_int j=0; j<ndep; ++j) {
+          if (s[i]<0 || s[j]<0) continue;
+          dd[s[i]][s[j]] += pdd[i+j];
+        }
+      }
+
+      // Pushing: second order adjoints involving node k
+      hk.clear();
+      hk.swap(hes[k]);
+      for (auto&& e : hk) {
+        if (e.first!=k) hes[e.first].erase(k);
+      }
+      for (auto&& e : hk) {
+        casadi_int p = e.first;
+        double w = e.second;
+        if (p==k) {
+          for (casadi_int i=0; i<na; ++i) {
+            for (casadi_int j=0; j<=i; ++j) add(a[i], a[j], d[i]*d[j]*w);
+          }
+        } else {
+          for (casadi_int i=0; i<na; ++i) {
+            add(a[i], p, (a[i]==p ? 2 : 1)*d[i]*w);
+          }
+        }
+      }
+
+      // Creating: second order partials weighted by the adjoint
+      if (adj[k]!=0) {
+        for (casadi_int i=0; i<na; ++i) {
+          for (casadi_int j=0; j<=i; ++j) add(a[i], a[j], adj[k]*dd[i][j]);
+        }
+      }
+
+      // Adjoint
+      for (casadi_int i=0; i<na; ++i) adj[a[i]] += adj[k]*d[i];
+    }
+  }
+
+  int EdgePushing::init_mem(void* mem) const {
+    if (FunctionInternal::init_mem(mem)) return 1;
+    auto m = static_cast<EdgePushingMemory*>(mem);
+    m->val.resize(op_.size());
+    m->adj.resize(op_.size());
+    m->hes.resize(op_.size());
+    return 0;
+  }
+
+  int EdgePushing::eval(const double** arg, double** res, casadi_int* iw, double* w,
+      void* mem) const {
+    auto m = static_cast<EdgePushingMemory*>(mem);
+    casadi_int n = op_.size();
+    double* val = get_ptr(m->val);
+
+    // Forward sweep
+    for (casadi_int k=0; k<n; ++k) {
+      switch (op_[k]) {
+        case OP_CONST:
+          val[k] = con_[k];
+          break;
+        case OP_INPUT:
+          val[k] = arg[in_ind_[k]] ? arg[in_ind_[k]][in_nz_[k]] : 0;
+          break;
+        default:
+          {
+            double x = val[arg0_[k]], y = arg1_[k]>=0 ? val[arg1_[k]] : x;
+            casadi_math<double>::fun(op_[k], x, y, val[k]);
+          }
+      }
+    }
+
+    // Reverse sweep
+    sweep(val, get_ptr(m->adj), m->hes, true);
+
+    // Scatter to the Hessian nonzeros
+    if (!res[0]) return 0;
+    casadi_clear(res[0], sp_.nnz());
+    const casadi_int *colind = sp_.colind(), *row = sp_.row();
+    for (casadi_int k=0; k<n; ++k) {
+      if (op_[k]!=OP_INPUT || in_ind_[k]!=iind_) continue;
+      casadi_int c = lin_[in_nz_[k]];
+      for (auto&& e : m->hes[k]) {
+        casadi_int r = lin_[in_nz_[e.first]];
+        if (triangle_=="triu" && r>c) continue;
+        if (triangle_=="tril" && r<c) continue;
+        const casadi_int* it = std::lower_bound(row+colind[c], row+colind[c+1], r);
+        casadi_assert_dev(it!=row+colind[c+1] && *it==r);
+        res[0][it-row] = e.second;
+      }
+    }
+    return 0;
+  }
+
+  void EdgePushing::serialize_body(SerializingStream &s) const {
+    FunctionInternal::serialize_body(s);
+    s.version("EdgePushing", 1);
+    s.pack("EdgePushing::f", f_);
+    s.pack("EdgePushing::iind", iind_);
+    s.pack("EdgePushing::oind", oind_);
+    s.pack("EdgePushing::triangle", triangle_);
+    s.pack("EdgePushing::hname", hname_);
+    s.pack("EdgePushing::sp", sp_);
+  }
+
+  EdgePushing::EdgePushing(DeserializingStream& s) : FunctionInternal(s) {
+    s.version("EdgePushing", 1);
+    s.unpack("EdgePushing::f", f_);
+    s.unpack("EdgePushing::iind", iind_);
+    s.unpack("EdgePushing::oind", oind_);
+    s.unpack("EdgePushing::triangle", triangle_);
+    s.unpack("EdgePushing::hname", hname_);
+    s.unpack("EdgePushing::sp", sp_);
+    record();
+  }
+
+} // namespace casadi
@@ -0,0 +1,167 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_EDGE_PUSHING_HPP
+#define CASADI_EDGE_PUSHING_HPP
+
+#include "function_internal.hpp"
+#include <unordered_map>
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Memory for EdgePushing */
+  struct CASADI_EXPORT EdgePushingMemory : public FunctionMemory {
+    // Values of the tape nodes
+    std::vector<double> val;
+    // First order adjoints of the tape nodes
+    std::vector<double> adj;
+    // Second order adjoints, symmetric, stored in both directions
+    std::vector<std::unordered_map<casadi_int, double> > hes;
+  };
+
+  /** \brief Sparse Hessian of a scalar SX function by edge pushing
+
+      Evaluates the Hessian of one scalar output with respect to one input
+      numerically, in a single reverse sweep over the algorithm of an SXFunction
+      that propagates first and (sparse, symmetric) second order adjoints.
+      Neither a symbolic gradient nor a graph coloring is formed.
+
+      Reference: Gower, Mello, "A new framework for the computation of Hessians",
+      Optimization Methods and Software, 2012.
+  */
+  class CASADI_EXPORT EdgePushing : public FunctionInternal {
+  public:
+    /** \brief Constructor
+
+        \param f Function with an algorithm (SXFunction)
+        \param iind Input index, the Hessian is taken with respect to all its nonzeros
+        \param oind Output index, must be scalar
+        \param triangle "full", "triu" or "tril"
+     */
+    EdgePushing(const std::string& name, const Function& f, casadi_int iind, casadi_int oind,
+      const std::string& triangle, const std::string& name_out);
+
+    /** \brief  Destructor */
+    ~EdgePushing() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override {return "EdgePushing";}
+
+    ///@{
+    /** \brief Number of function inputs and outputs */
+    size_t get_n_in() override { return f_.n_in();}
+    size_t get_n_out() override { return 1;}
+    ///@}
+
+    /// @{
+    /** \brief Sparsities of function inputs and outputs */
+    Sparsity get_sparsity_in(casadi_int i) override { return f_.sparsity_in(i);}
+    Sparsity get_sparsity_out(casadi_int i) override { return sp_;}
+    /// @}
+
+    ///@{
+    /** \brief Names of function input and outputs */
+    std::string get_name_in(casadi_int i) override { return f_.name_in(i);}
+    std::string get_name_out(casadi_int i) override { return hname_;}
+    /// @}
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new EdgePushingMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<EdgePushingMemory*>(mem);}
+
+    /** \brief  Evaluate numerically, work vectors given */
+    int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
+
+    /** \brief Check if an operation is supported, and get its structure
+
+        d_sp: structurally nonzero first order partials,
+        dd_sp: structurally nonzero second order partials (xx, xy, yy)
+     */
+    static bool structure(casadi_int op, bool* d_sp, bool* dd_sp);
+
+    /** \brief Second order partials (xx, xy, yy) of an elementary operation */
+    static void der2(casadi_int op, double x, double y, double f, double* dd);
+
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream &s) const override;
+
+    /** \brief Deserialize without type information */
+    static ProtoFunction* deserialize(DeserializingStream& s) { return new EdgePushing(s); }
+
+  protected:
+    /** \brief Deserializing constructor */
+    explicit EdgePushing(DeserializingStream& s);
+
+    /** \brief Record the tape from the algorithm of f_ */
+    void record();
+
+    /** \brief Reverse sweep, numeric or (with unit partials) structural */
+    void sweep(const double* val, double* adj,
+      std::vector<std::unordered_map<casadi_int, double> >& hes, bool numeric) const;
+
+    // Function to be differentiated
+    Function f_;
+
+    // Input and output index
+    casadi_int iind_, oind_;
+
+    // Part of the Hessian to be returned: "full", "triu" or "tril"
+    std::string triangle_;
+
+    // Name of the output
+    std::string hname_;
+
+    // Hessian sparsity
+    Sparsity sp_;
+
+    // Tape: operation, arguments (-1 if none), constant value or input nonzero
+    std::vector<casadi_int> op_, arg0_, arg1_;
+    std::vector<double> con_;
+
+    // Tape nodes that depend on input iind_
+    std::vector<bool> active_;
+
+    // For input nodes: input index and nonzero
+    std::vector<casadi_int> in_ind_, in_nz_;
+
+    // Tape node of the scalar output, -1 if structurally zero
+    casadi_int out_node_;
+
+    // Linear index of each nonzero of input iind_
+    std::vector<casadi_int> lin_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_EDGE_PUSHING_HPP
@@ -47,11 +47,11 @@ Fmu::Fmu(const std::string& name, FmuApi api, const DaeBuilderInternal* dae,
     const std::vector<std::string>& scheme_in,
     const std::vector<std::string>& scheme_out,
     const std::map<std::string, std::vector<size_t>>& scheme,
-    const std::vector<std::string>& aux) {
+    const std::vector<std::string>& aux, casadi_int instance_pool_size) {
   if (api == FmuApi::FMI2) {
 #ifdef WITH_FMI2
   // Create
-  own(new Fmu2(name, scheme_in, scheme_out, scheme, aux));
+  own(new Fmu2(name, scheme_in, scheme_out, scheme, aux, instance_pool_size));
 #else  // WITH_FMI2
   // No compilation support
   casadi_error("CasADi was not compiled with WITH_FMI2=ON.");
@@ -236,6 +236,14 @@ void Fmu::free_instance(void* c) const {
   }
 }
 
+void Fmu::release_instance(FmuMemory* m) const {
+  try {
+    return (*this)->release_instance(m);
+  } catch(std::exception& e) {
+    THROW_ERROR("release_instance", e.what());
+  }
+}
+
 void Fmu::set(FmuMemory* m, size_t ind, const double* value) const {
   try {
     return (*this)->set(m, ind, value);
@@ -338,8 +346,10 @@ FmuInternal::FmuInternal(const std::string& name,
     const std::vector<std::string>& scheme_in,
     const std::vector<std::string>& scheme_out,
     const std::map<std::string, std::vector<size_t>>& scheme,
-    const std::vector<std::string>& aux)
-    : name_(name), scheme_in_(scheme_in), scheme_out_(scheme_out), scheme_(scheme), aux_(aux) {
+    const std::vector<std::string>& aux,
+    casadi_int instance_pool_size)
+    : name_(name), scheme_in_(scheme_in), scheme_out_(scheme_out), scheme_(scheme), aux_(aux),
+    instance_pool_size_(instance_pool_size) {
 }
 
 FmuInternal::~FmuInternal() {
@@ -429,6 +439,66 @@ std::string FmuInternal::desc_in(FmuMemory* m, size_t id, bool more) const {
   }
 }
 
+int FmuInternal::checkout_instance(FmuMemory* m) const {
+  // Ensure not already instantiated
+  casadi_assert(m->instance == 0, "Already instantiated");
+  // Look for an idle instance in the pool
+  {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(pool_mtx_);
+#endif // CASADI_WITH_THREAD
+    if (!pool_.empty()) {
+      m->instance = pool_.back().first;
+      m->instance_state = pool_.back().second;
+      pool_.pop_back();
+    }
+  }
+  // Create a new instance if none was available
+  if (m->instance == 0) return init_instance(m);
+  // Reuse instance, bring it back to its initialized state
+  if (restore_instance(m)) {
+    // Restore failed, discard the instance and create a new one
+    if (m->instance_state) free_state(m->instance, m->instance_state);
+    free_instance(m->instance);
+    m->instance = m->instance_state = nullptr;
+    return init_instance(m);
+  }
+  return 0;
+}
+
+void FmuInternal::release_instance(FmuMemory* m) const {
+  // Quick return if no instance
+  if (m->instance == 0) return;
+  // Try to add the instance to the pool
+  bool pooled = false;
+  {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(pool_mtx_);
+#endif // CASADI_WITH_THREAD
+    if (static_cast<casadi_int>(pool_.size()) < instance_pool_size_) {
+      pool_.push_back(std::make_pair(m->instance, m->instance_state));
+      pooled = true;
+    }
+  }
+  // Pool is full, free the instance
+  if (!pooled) {
+    if (m->instance_state) free_state(m->instance, m->instance_state);
+    free_instance(m->instance);
+  }
+  m->instance = m->instance_state = nullptr;
+}
+
+void FmuInternal::clear_pool() {
+#ifdef CASADI_WITH_THREAD
+  std::lock_guard<std::mutex> lock(pool_mtx_);
+#endif // CASADI_WITH_THREAD
+  for (auto&& e : pool_) {
+    if (e.second) free_state(e.first, e.second);
+    free_instance(e.first);
+  }
+  pool_.clear();
+}
+
 int FmuInternal::eval_derivative(FmuMemory* m, bool independent_seeds) const {
   // Gather input and output indices
   gather_sens(m);
@@ -451,7 +521,7 @@ void FmuInternal::set(FmuMemory* m, size_t ind, const double* value) const {
     for (size_t id : ired_[ind]) {
       if (*value != m->ibuf_.at(id)) {
         m->ibuf_.at(id) = *value;
-        m->changed_.at(id) = true;
+        m->mark_changed(id);
       }
       value++;
     }
@@ -460,7 +530,7 @@ void FmuInternal::set(FmuMemory* m, size_t ind, const double* value) const {
     for (size_t id : ired_[ind]) {
       if (0 != m->ibuf_.at(id)) {
         m->ibuf_.at(id) = 0;
-        m->changed_.at(id) = true;
+        m->mark_changed(id);
       }
     }
   }
@@ -469,7 +539,7 @@ void FmuInternal::set(FmuMemory* m, size_t ind, const double* value) const {
 void FmuInternal::request(FmuMemory* m, size_t ind) const {
   for (size_t id : ored_[ind]) {
     // Mark as requested
-    m->requested_.at(id) = true;
+    m->mark_requested(id);
     // Also log corresponding input index
     m->wrt_.at(id) = -1;
   }
@@ -486,7 +556,7 @@ void FmuInternal::set_seed(FmuMemory* m, casadi_int nseed,
     const casadi_int* id, const double* v) const {
   for (casadi_int i = 0; i < nseed; ++i) {
     m->seed_.at(*id) = *v++;
-    m->changed_.at(*id) = true;
+    m->mark_changed(*id);
     id++;
   }
 }
@@ -494,7 +564,7 @@ void FmuInternal::set_seed(FmuMemory* m, casadi_int nseed,
 void FmuInternal::request_sens(FmuMemory* m, casadi_int nsens, const casadi_int* id,
     const casadi_int* wrt_id) const {
   for (casadi_int i = 0; i < nsens; ++i) {
-    m->requested_.at(*id) = true;
+    m->mark_requested(*id);
     m->wrt_.at(*id) = *wrt_id++;
     id++;
   }
@@ -536,27 +606,30 @@ void FmuInternal::get_fwd(FmuMemory* m, size_t ind, double* v) const {
 }
 
 void FmuInternal::gather_io(FmuMemory* m) const {
-  // Collect input indices and corresponding value references and values
-  m->id_in_.clear();
-  m->vr_in_.clear();
-  m->v_in_.clear();
-  for (size_t id = 0; id < m->changed_.size(); ++id) {
-    if (m->changed_[id]) {
-      m->id_in_.push_back(id);
-      m->vr_in_.push_back(vr_in_[id]);
-      m->v_in_.push_back(m->ibuf_[id]);
-      m->changed_[id] = false;
-    }
-  }
-  // Collect output indices, corresponding value references
-  m->id_out_.clear();
-  m->vr_out_.clear();
-  for (size_t id = 0; id < m->requested_.size(); ++id) {
-    if (m->requested_[id]) {
-      m->id_out_.push_back(id);
-      m->vr_out_.push_back(vr_out_[id]);
-      m->requested_[id] = false;
-    }
+  // Changed inputs, in the order they were marked (cost independent of total number of inputs)
+  m->id_in_.swap(m->pending_in_);
+  m->pending_in_.clear();
+  // Collect corresponding value references and values
+  size_t n_in = m->id_in_.size();
+  m->vr_in_.resize(n_in);
+  m->v_in_.resize(n_in);
+  for (size_t k = 0; k < n_in; ++k) {
+    size_t id = m->id_in_[k];
+    m->vr_in_[k] = vr_in_[id];
+    m->v_in_[k] = m->ibuf_[id];
+    m->pos_in_[id] = k;
+    m->changed_[id] = false;
+  }
+  // Requested outputs
+  m->id_out_.swap(m->pending_out_);
+  m->pending_out_.clear();
+  // Collect corresponding value references
+  size_t n_out = m->id_out_.size();
+  m->vr_out_.resize(n_out);
+  for (size_t k = 0; k < n_out; ++k) {
+    size_t id = m->id_out_[k];
+    m->vr_out_[k] = vr_out_[id];
+    m->requested_[id] = false;
   }
 }
 
@@ -604,7 +677,7 @@ void FmuInternal::serialize_type(SerializingStream& s) const {
 }
 
 void FmuInternal::serialize_body(SerializingStream& s) const {
-  s.version("FmuInternal", 1);
+  s.version("FmuInternal", 2);
   s.pack("FmuInternal::name", name_);
   s.pack("FmuInternal::scheme_in", scheme_in_);
   s.pack("FmuInternal::scheme_out", scheme_out_);
@@ -631,12 +704,11 @@ void FmuInternal::serialize_body(SerializingStream& s) const {
   s.pack("FmuInternal::ored", ored_);
   s.pack("FmuInternal::jac_sp", jac_sp_);
   s.pack("FmuInternal::hess_sp", hess_sp_);
-
-
+  s.pack("FmuInternal::instance_pool_size", instance_pool_size_);
 }
 
 FmuInternal::FmuInternal(DeserializingStream& s) {
-  s.version("FmuInternal", 1);
+  int version = s.version("FmuInternal", 1, 2);
   s.unpack("FmuInternal::name", name_);
   s.unpack("FmuInternal::scheme_in", scheme_in_);
   s.unpack("FmuInternal::scheme_out", scheme_out_);
@@ -663,6 +735,11 @@ FmuInternal::FmuInternal(DeserializingStream& s) {
   s.unpack("FmuInternal::ored", ored_);
   s.unpack("FmuInternal::jac_sp", jac_sp_);
   s.unpack("FmuInternal::hess_sp", hess_sp_);
+  if (version >= 2) {
+    s.unpack("FmuInternal::instance_pool_size", instance_pool_size_);
+  } else {
+    instance_pool_size_ = 0;
+  }
 }
 
 FmuInternal* FmuInternal::deserialize(DeserializingStream& s) {
@@ -73,7 +73,7 @@ class CASADI_EXPORT Fmu
     const std::vector<std::string>& scheme_in,
     const std::vector<std::string>& scheme_out,
     const std::map<std::string, std::vector<size_t>>& scheme,
-    const std::vector<std::string>& aux);
+    const std::vector<std::string>& aux, casadi_int instance_pool_size = 0);
 
   /** \brief Name of the instance
 
@@ -157,6 +157,9 @@ class CASADI_EXPORT Fmu
   // Free FMU instance
   void free_instance(void* c) const;
 
+  // Return FMU instance to the pool of reusable instances
+  void release_instance(FmuMemory* m) const;
+
   // Set value
   void set(FmuMemory* m, size_t ind, const double* value) const;
 
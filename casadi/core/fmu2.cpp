@@ -32,6 +32,8 @@ namespace casadi {
 #ifdef WITH_FMI2
 
 Fmu2::~Fmu2() {
+  // Free idle FMU instances
+  clear_pool();
 }
 
 std::string Fmu2::system_infix() {
@@ -261,10 +263,7 @@ void Fmu2::init(const DaeBuilderInternal* dae) {
   li_ = Importer(dll_path, "dll");
 
   declared_ad_ = dae->provides_directional_derivative_;
-
-  if (dae->provides_directional_derivative_) {
-
-  }
+  can_get_and_set_fmu_state_ = dae->can_get_and_set_fmu_state_;
 
   // Path to resource directory
   resource_loc_ = "file://" + dae->path_ + "/resources";
@@ -302,6 +301,12 @@ void Fmu2::finalize() {
       load_function<fmi2GetDirectionalDerivativeTYPE>("fmi2GetDirectionalDerivative");
   }
 
+  if (can_get_and_set_fmu_state_) {
+    get_fmu_state_ = load_function<fmi2GetFMUstateTYPE>("fmi2GetFMUstate");
+    set_fmu_state_ = load_function<fmi2SetFMUstateTYPE>("fmi2SetFMUstate");
+    free_fmu_state_ = load_function<fmi2FreeFMUstateTYPE>("fmi2FreeFMUstate");
+  }
+
   // Callback functions
   functions_.logger = logger;
   functions_.allocateMemory = calloc;
@@ -329,8 +334,12 @@ void Fmu2::finalize() {
   if (get_aux(c, &aux_value_)) {
     casadi_error("Fmu2::get_aux failed");
   }
-  // Free memory
-  free_instance(c);
+  // Keep the instance for reuse, if pooling is enabled
+  if (instance_pool_size_ > 0 && !exit_initialization_mode(c)) {
+    pool_.push_back(std::make_pair(c, get_state(c)));
+  } else {
+    free_instance(c);
+  }
 }
 
 void Fmu2::logger(fmi2ComponentEnvironment componentEnvironment,
@@ -386,9 +395,7 @@ void Fmu2::free_instance(void* c) const {
   }
 }
 
-int Fmu2::init_mem(FmuMemory* m) const {
-  // Ensure not already instantiated
-  casadi_assert(m->instance == 0, "Already instantiated");
+int Fmu2::init_instance(FmuMemory* m) const {
   // Create instance
   m->instance = instantiate();
   // Reset solver
@@ -402,6 +409,55 @@ int Fmu2::init_mem(FmuMemory* m) const {
   if (enter_initialization_mode(m->instance)) return 1;
   // Initialization mode ends
   if (exit_initialization_mode(m->instance)) return 1;
+  // Snapshot of the initialized state, for cheap restoring if instance is reused
+  if (instance_pool_size_ > 0) m->instance_state = get_state(m->instance);
+  // Successful return
+  return 0;
+}
+
+int Fmu2::restore_instance(FmuMemory* m) const {
+  fmi2Component c = m->instance;
+  if (m->instance_state) {
+    // Restore the snapshot taken after initialization
+    fmi2Status status = set_fmu_state_(c, m->instance_state);
+    if (status != fmi2OK) {
+      casadi_warning("fmi2SetFMUstate failed");
+      return 1;
+    }
+  } else {
+    // No snapshot available: Reset and repeat initialization (no reinstantiation)
+    if (reset(c)) return 1;
+    setup_experiment(c);
+    if (set_values(c)) return 1;
+    if (enter_initialization_mode(c)) return 1;
+    if (exit_initialization_mode(c)) return 1;
+  }
+  // Successful return
+  return 0;
+}
+
+fmi2FMUstate Fmu2::get_state(fmi2Component c) const {
+  // Quick return if not supported
+  if (!get_fmu_state_) return nullptr;
+  // Get a snapshot of the FMU state
+  fmi2FMUstate s = nullptr;
+  fmi2Status status = get_fmu_state_(c, &s);
+  if (status != fmi2OK) {
+    casadi_warning("fmi2GetFMUstate failed");
+    return nullptr;
+  }
+  return s;
+}
+
+void Fmu2::free_state(void* c, void* s) const {
+  fmi2FMUstate s2 = static_cast<fmi2FMUstate>(s);
+  fmi2Status status = free_fmu_state_(static_cast<fmi2Component>(c), &s2);
+  if (status != fmi2OK) casadi_warning("fmi2FreeFMUstate failed");
+}
+
+int Fmu2::init_mem(FmuMemory* m) const {
+  // Get an initialized instance, reusing an idle one if possible
+  if (checkout_instance(m)) return 1;
   // Allocate/reset input buffer
   m->ibuf_.resize(iind_.size());
   std::fill(m->ibuf_.begin(), m->ibuf_.end(), casadi::nan);
@@ -417,9 +473,14 @@ int Fmu2::init_mem(FmuMemory* m) const {
   // Allocate/reset changed
   m->changed_.resize(iind_.size());
   std::fill(m->changed_.begin(), m->changed_.end(), false);
+  m->pending_in_.clear();
+  m->pending_in_.reserve(iind_.size());
+  m->pos_in_.resize(iind_.size());
   // Allocate/reset requested
   m->requested_.resize(oind_.size());
   std::fill(m->requested_.begin(), m->requested_.end(), false);
+  m->pending_out_.clear();
+  m->pending_out_.reserve(oind_.size());
   // Also allocate memory for corresponding Jacobian entry (for debugging)
   m->wrt_.resize(oind_.size());
   // Successful return
@@ -432,7 +493,7 @@ void Fmu2::setup_experiment(fmi2Component c) const {
   casadi_assert(status == fmi2OK, "fmi2SetupExperiment failed");
 }
 
-int Fmu2::reset(fmi2Component c) {
+int Fmu2::reset(fmi2Component c) const {
   fmi2Status status = reset_(c);
   if (status != fmi2OK) {
     casadi_warning("fmi2Reset failed");
@@ -759,10 +820,8 @@ int Fmu2::eval_fd(FmuMemory* m, bool independent_seeds) const {
       // Differentiation with respect to what variable
       size_t wrt_id = m->wrt_.at(id);
       // Find the corresponding input variable
-      size_t wrt_i;
-      for (wrt_i = 0; wrt_i < n_known; ++wrt_i) {
-        if (m->id_in_[wrt_i] == wrt_id) break;
-      }
+      size_t wrt_i = m->pos_in_.at(wrt_id);
+      casadi_assert_dev(m->id_in_.at(wrt_i) == wrt_id);
       // Check if in bounds
       if (m->in_bounds_.at(wrt_i)) {
         // Input was in bounds: Keep output, make dimensionless
@@ -792,10 +851,7 @@ int Fmu2::eval_fd(FmuMemory* m, bool independent_seeds) const {
     // With respect to what variable
     size_t wrt = m->wrt_[id];
     // Find the corresponding input variable
-    size_t wrt_i;
-    for (wrt_i = 0; wrt_i < n_known; ++wrt_i) {
-      if (m->id_in_[wrt_i] == wrt) break;
-    }
+    size_t wrt_i = m->pos_in_.at(wrt);
     // Nominal value
     double n = nominal_out_[id];
     // Get the value
@@ -881,8 +937,9 @@ Fmu2::Fmu2(const std::string& name,
     const std::vector<std::string>& scheme_in,
     const std::vector<std::string>& scheme_out,
     const std::map<std::string, std::vector<size_t>>& scheme,
-    const std::vector<std::string>& aux)
-    : FmuInternal(name, scheme_in, scheme_out, scheme, aux) {
+    const std::vector<std::string>& aux,
+    casadi_int instance_pool_size)
+    : FmuInternal(name, scheme_in, scheme_out, scheme, aux, instance_pool_size) {
   instantiate_ = 0;
   free_instance_ = 0;
   reset_ = 0;
@@ -894,6 +951,10 @@ Fmu2::Fmu2(const std::string& name,
   set_boolean_ = 0;
   get_real_ = 0;
   get_directional_derivative_ = 0;
+  get_fmu_state_ = 0;
+  set_fmu_state_ = 0;
+  free_fmu_state_ = 0;
+  can_get_and_set_fmu_state_ = false;
 }
 
 Fmu2* Fmu2::deserialize(DeserializingStream& s) {
@@ -914,8 +975,11 @@ Fmu2::Fmu2(DeserializingStream& s) : FmuInternal(s) {
   set_boolean_ = 0;
   get_real_ = 0;
   get_directional_derivative_ = 0;
+  get_fmu_state_ = 0;
+  set_fmu_state_ = 0;
+  free_fmu_state_ = 0;
 
-  s.version("Fmu2", 1);
+  int version = s.version("Fmu2", 1, 2);
   s.unpack("Fmu2::resource_loc", resource_loc_);
   s.unpack("Fmu2::fmutol", fmutol_);
   s.unpack("Fmu2::instance_name", instance_name_);
@@ -941,14 +1005,18 @@ Fmu2::Fmu2(DeserializingStream& s) : FmuInternal(s) {
   s.unpack("Fmu2::vr_aux_string", vr_aux_string_);
 
   s.unpack("Fmu2::declared_ad", declared_ad_);
-
+  if (version >= 2) {
+    s.unpack("Fmu2::can_get_and_set_fmu_state", can_get_and_set_fmu_state_);
+  } else {
+    can_get_and_set_fmu_state_ = false;
+  }
 }
 
 
 void Fmu2::serialize_body(SerializingStream &s) const {
   FmuInternal::serialize_body(s);
 
-  s.version("Fmu2", 1);
+  s.version("Fmu2", 2);
   s.pack("Fmu2::resource_loc", resource_loc_);
   s.pack("Fmu2::fmutol", fmutol_);
   s.pack("Fmu2::instance_name", instance_name_);
@@ -974,6 +1042,7 @@ void Fmu2::serialize_body(SerializingStream &s) const {
   s.pack("Fmu2::vr_aux_string_", vr_aux_string_);
 
   s.pack("Fmu2::declared_ad", declared_ad_);
+  s.pack("Fmu2::can_get_and_set_fmu_state", can_get_and_set_fmu_state_);
 }
 
 #endif  // WITH_FMI2
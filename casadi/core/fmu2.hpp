@@ -46,7 +46,8 @@ class CASADI_EXPORT Fmu2 : public FmuInternal {
   // Constructor
   Fmu2(const std::string& name,
     const std::vector<std::string>& scheme_in, const std::vector<std::string>& scheme_out,
-    const std::map<std::string, std::vector<size_t>>& scheme, const std::vector<std::string>& aux);
+    const std::map<std::string, std::vector<size_t>>& scheme, const std::vector<std::string>& aux,
+    casadi_int instance_pool_size);
 
   /// Destructor
   ~Fmu2() override;
@@ -91,6 +92,9 @@ class CASADI_EXPORT Fmu2 : public FmuInternal {
   // Does the FMU declare analytic derivatives support?
   bool declared_ad_;
 
+  // Does the FMU declare support for getting and setting the FMU state?
+  bool can_get_and_set_fmu_state_;
+
   // Following members set in finalize
 
   // FMU C API function prototypes. Cf. FMI specification 2.0.2
@@ -110,6 +114,9 @@ class CASADI_EXPORT Fmu2 : public FmuInternal {
   fmi2GetStringTYPE* get_string_;
   fmi2SetStringTYPE* set_string_;
   fmi2GetDirectionalDerivativeTYPE* get_directional_derivative_;
+  fmi2GetFMUstateTYPE* get_fmu_state_;
+  fmi2SetFMUstateTYPE* set_fmu_state_;
+  fmi2FreeFMUstateTYPE* free_fmu_state_;
 
   // Callback functions
   fmi2CallbackFunctions functions_;
@@ -134,7 +141,19 @@ class CASADI_EXPORT Fmu2 : public FmuInternal {
   void free_instance(void* c) const override;
 
   // Reset solver
-  int reset(fmi2Component c);
+  int reset(fmi2Component c) const;
+
+  // Create and initialize a new FMU instance
+  int init_instance(FmuMemory* m) const override;
+
+  // Bring a previously used FMU instance back to its initialized state
+  int restore_instance(FmuMemory* m) const override;
+
+  // Snapshot of the FMU state, null if not supported
+  fmi2FMUstate get_state(fmi2Component c) const;
+
+  // Free a snapshot of the FMU state
+  void free_state(void* c, void* s) const override;
 
   // Setup experiment
   void setup_experiment(fmi2Component c) const;
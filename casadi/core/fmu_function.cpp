@@ -61,14 +61,21 @@ int FmuFunction::init_mem(void* mem) const {
     FmuMemory* m1 = i == 0 ? m : m->slaves.at(i - 1);
     if (fmu_.init_mem(m1)) return 1;
   }
+  // Storage for cached derivatives, owned by the master memory object
+  if (cache_derivatives_) {
+    m->cache_x_.clear();
+    m->cache_jac_.resize(jac_sp_.nnz());
+    if (has_hess_) m->cache_hess_.resize(hess_colors_.size2() * jac_sp_.nnz());
+  }
+  m->cache_jac_valid_ = m->cache_hess_valid_ = false;
   return 0;
 }
 
 void* FmuFunction::alloc_mem() const {
   // Create (master) memory object
   FmuMemory* m = new FmuMemory(*this);
-  // Attach additional (slave) memory objects
-  for (casadi_int i = 1; i < max_jac_tasks_; ++i) {
+  // Attach additional (slave) memory objects, one per additional parallel task
+  for (casadi_int i = 1; i < std::max(max_jac_tasks_, max_hess_tasks_); ++i) {
     m->slaves.push_back(new FmuMemory(*this));
   }
   return m;
@@ -81,19 +88,13 @@ void FmuFunction::free_mem(void *mem) const {
   // Free slave memory
   for (FmuMemory*& s : m->slaves) {
     if (!s) continue;
-    // Free FMU memory
-    if (s->instance) {
-      fmu_.free_instance(s->instance);
-      s->instance = nullptr;
-    }
+    // Return FMU instance to the pool (or free it)
+    fmu_.release_instance(s);
     // Free the slave
     delete s;
   }
-  // Free FMI memory
-  if (m->instance) {
-    fmu_.free_instance(m->instance);
-    m->instance = nullptr;
-  }
+  // Return FMU instance to the pool (or free it)
+  fmu_.release_instance(m);
   // Free the memory object
   delete m;
 }
@@ -138,6 +139,7 @@ FmuFunction::FmuFunction(const std::string& name, const Fmu& fmu,
   new_forward_ = false;
   new_hessian_ = true;
   hessian_coloring_ = true;
+  cache_derivatives_ = false;
   parallelization_ = Parallelization::SERIAL;
   // Number of parallel tasks, by default
   max_n_tasks_ = 1;
@@ -173,6 +175,11 @@ const Options FmuFunction::options_
     {"aux",
      {OT_STRINGVECTOR,
       "Auxilliary variables"}},
+    {"instance_pool_size",
+     {OT_INT,
+      "Maximum number of idle FMU instances kept for reuse by memory objects of the FMU "
+      "and its derivative functions [default: 0]. Reused instances are restored to their "
+      "initialized state using fmi2SetFMUstate, if supported, otherwise with fmi2Reset."}},
     {"enable_ad",
      {OT_BOOL,
       "Calculate first order derivatives using FMU directional derivative support"}},
@@ -212,7 +219,13 @@ const Options FmuFunction::options_
     {"hessian_coloring",
      {OT_BOOL,
       "Enable the use of graph coloring (star coloring) for Hessian calculation. "
-      "Note that disabling the coloring can improve symmetry check diagnostics."}}
+      "Note that disabling the coloring can improve symmetry check diagnostics."}},
+    {"cache_derivatives",
+     {OT_BOOL,
+      "Keep the extended Jacobian, and for Hessian calculation also the perturbed "
+      "extended Jacobians, from the last evaluation. Subsequent evaluations at the same "
+      "values of the regular inputs, e.g. with different adjoint seeds, reuse them "
+      "instead of evaluating the FMU."}}
    }
 };
 
@@ -245,6 +258,8 @@ void FmuFunction::init(const Dict& opts) {
       new_hessian_ = op.second;
     } else if (op.first=="hessian_coloring") {
       hessian_coloring_ = op.second;
+    } else if (op.first=="cache_derivatives") {
+      cache_derivatives_ = op.second;
     }
   }
 
@@ -837,6 +852,14 @@ int FmuFunction::eval(const double** arg, double** res, casadi_int* iw, double*
     hess_nz = w; w += hess_sp_.nnz();
     std::fill(hess_nz, hess_nz + hess_sp_.nnz(), casadi::nan);
   }
+  // Reuse derivatives calculated at the same regular input values, if possible
+  bool jac_cached = false, hess_cached = false;
+  if (cache_derivatives_ && (need_jac || need_adj)) {
+    if (same_point(m, arg)) {
+      jac_cached = m->cache_jac_valid_;
+      hess_cached = need_hess && m->cache_hess_valid_;
+    }
+  }
   // Setup memory for threads
   for (casadi_int task = 0; task < max_n_tasks_; ++task) {
     FmuMemory* s = task == 0 ? m : m->slaves.at(task - 1);
@@ -847,6 +870,9 @@ int FmuFunction::eval(const double** arg, double** res, casadi_int* iw, double*
     s->asens = asens;
     s->jac_nz = jac_nz;
     s->hess_nz = hess_nz;
+    s->jac_cache = cache_derivatives_ ? get_ptr(m->cache_jac_) : 0;
+    s->hess_cache = cache_derivatives_ ? get_ptr(m->cache_hess_) : 0;
+    s->use_hess_cache = hess_cached;
     // Thread specific memory
     casadi_jac_init(&p_, &s->d, &iw, &w);
     if (task < max_hess_tasks_) {
@@ -860,11 +886,23 @@ int FmuFunction::eval(const double** arg, double** res, casadi_int* iw, double*
   }
   // Evaluate everything except Hessian, possibly in parallel
   if (verbose_) casadi_message("Evaluating regular outputs, forward sens, extended Jacobian");
-  if (eval_all(m, max_jac_tasks_, true, need_jac, need_fwd, need_adj, false)) return 1;
+  if (eval_all(m, max_jac_tasks_, true, need_jac && !jac_cached, need_fwd,
+    need_adj && !jac_cached, false)) return 1;
+  if (jac_cached) {
+    // Extended Jacobian available from a previous evaluation
+    if (verbose_) casadi_message("Reusing cached extended Jacobian");
+    if (need_jac) casadi_copy(get_ptr(m->cache_jac_), jac_sp_.nnz(), jac_nz);
+    if (need_adj) jac_adj(get_ptr(m->cache_jac_), aseed, asens);
+  } else if (cache_derivatives_ && (need_jac || need_adj)) {
+    // Extended Jacobian was stored during the evaluation
+    m->cache_jac_valid_ = true;
+  }
   // Evaluate Hessian
   if (need_hess) {
     if (verbose_) casadi_message("Evaluating extended Hessian");
-    if (eval_all(m, max_hess_tasks_, false, false, false, false, true)) return 1;
+    if (eval_all(m, hess_cached ? 1 : max_hess_tasks_, false, false, false, false, true)) return 1;
+    // Perturbed extended Jacobians were stored during the evaluation
+    if (cache_derivatives_) m->cache_hess_valid_ = true;
     // Post-process Hessian
     remove_nans(hess_nz, iw);
     if (check_hessian_) check_hessian(m, hess_nz, iw);
@@ -1034,6 +1072,12 @@ int FmuFunction::eval_task(FmuMemory* m, casadi_int task, casadi_int n_task,
           m->jac_nz[m->d.nzind[i]] = m->d.sens[i];
         }
       }
+      // Store in cache
+      if (m->jac_cache) {
+        for (casadi_int i = 0; i < m->d.nsens; ++i) {
+          m->jac_cache[m->d.nzind[i]] = m->d.sens[i];
+        }
+      }
       // Propagate adjoint sensitivities
       if (need_adj) {
         for (casadi_int i = 0; i < m->d.nsens; ++i)
@@ -1086,35 +1130,48 @@ int FmuFunction::eval_task(FmuMemory* m, casadi_int task, casadi_int n_task,
           // Take reverse step instead
           h[v] = -h[v];
         }
-        // Perturb the input
-        m->ibuf_.at(id) += h[v];
-        m->changed_.at(id) = true;
+        // Perturb the input, unless perturbed Jacobian is cached
+        if (!m->use_hess_cache) {
+          m->ibuf_.at(id) += h[v];
+          m->mark_changed(id);
+        }
         // Inverse of step size
         h[v] = 1. / h[v];
       }
-      // Request all outputs
-      for (size_t i : jac_out_) {
-        m->requested_.at(i) = true;
-        m->wrt_.at(i) = -1;
-      }
-      // Calculate perturbed inputs
-      if (fmu_.eval(m)) return 1;
+      // Cached perturbed extended Jacobian for color, if any
+      double* pert_jac = m->hess_cache ? m->hess_cache + c * jac_sp_.nnz() : 0;
       // Clear perturbed adjoint sensitivities
       std::fill(m->pert_asens, m->pert_asens + fmu_.n_in(), 0);
-      // Loop over colors of the Jacobian
-      for (casadi_int c1 = 0; c1 < jac_colors_.size2(); ++c1) {
-       // Get derivative directions
-       casadi_jac_pre(&p_, &m->d, c1);
-       // Calculate derivatives
-       fmu_.set_seed(m, m->d.nseed, m->d.iseed, m->d.seed);
-       fmu_.request_sens(m, m->d.nsens, m->d.isens, m->d.wrt);
-       if (fmu_.eval_derivative(m, true)) return 1;
-       fmu_.get_sens(m, m->d.nsens, m->d.isens, m->d.sens);
-       // Scale derivatives
-       casadi_jac_scale(&p_, &m->d);
-       // Propagate adjoint sensitivities
-       for (casadi_int i = 0; i < m->d.nsens; ++i)
-         m->pert_asens[m->d.wrt[i]] += m->aseed[m->d.isens[i]] * m->d.sens[i];
+      if (m->use_hess_cache) {
+        // Propagate adjoint sensitivities using cached perturbed Jacobian
+        jac_adj(pert_jac, m->aseed, m->pert_asens);
+      } else {
+        // Request all outputs
+        for (size_t i : jac_out_) {
+          m->mark_requested(i);
+          m->wrt_.at(i) = -1;
+        }
+        // Calculate perturbed inputs
+        if (fmu_.eval(m)) return 1;
+        // Loop over colors of the Jacobian
+        for (casadi_int c1 = 0; c1 < jac_colors_.size2(); ++c1) {
+          // Get derivative directions
+          casadi_jac_pre(&p_, &m->d, c1);
+          // Calculate derivatives
+          fmu_.set_seed(m, m->d.nseed, m->d.iseed, m->d.seed);
+          fmu_.request_sens(m, m->d.nsens, m->d.isens, m->d.wrt);
+          if (fmu_.eval_derivative(m, true)) return 1;
+          fmu_.get_sens(m, m->d.nsens, m->d.isens, m->d.sens);
+          // Scale derivatives
+          casadi_jac_scale(&p_, &m->d);
+          // Propagate adjoint sensitivities
+          for (casadi_int i = 0; i < m->d.nsens; ++i)
+            m->pert_asens[m->d.wrt[i]] += m->aseed[m->d.isens[i]] * m->d.sens[i];
+          // Store in cache
+          if (pert_jac) {
+            for (casadi_int i = 0; i < m->d.nsens; ++i) pert_jac[m->d.nzind[i]] = m->d.sens[i];
+          }
+        }
       }
       // Count how many times each input is calculated
       std::fill(m->star_iw, m->star_iw + fmu_.n_in(), 0);
@@ -1131,8 +1188,10 @@ int FmuFunction::eval_task(FmuMemory* m, casadi_int task, casadi_int n_task,
         casadi_int ind1 = hc_row[v_begin + v];
         casadi_int id = jac_in_.at(ind1);
         // Restore input
-        m->ibuf_.at(id) = x[v];
-        m->changed_.at(id) = true;
+        if (!m->use_hess_cache) {
+          m->ibuf_.at(id) = x[v];
+          m->mark_changed(id);
+        }
         // Get column in Hessian
         for (casadi_int k = hess_colind[ind1]; k < hess_colind[ind1 + 1]; ++k) {
           casadi_int id2 = jac_in_.at(hess_row[k]);
@@ -1153,6 +1212,50 @@ int FmuFunction::eval_task(FmuMemory* m, casadi_int task, casadi_int n_task,
   return 0;
 }
 
+bool FmuFunction::same_point(FmuMemory* m, const double** arg) const {
+  // Number of regular input values
+  size_t n = 0;
+  for (auto&& e : in_) {
+    if (e.type == InputType::REG) n += fmu_.ired(e.ind).size();
+  }
+  // Any cached values?
+  bool same = m->cache_x_.size() == n;
+  if (!same) m->cache_x_.resize(n);
+  // Compare with values for cached derivatives, update if needed
+  double* x = get_ptr(m->cache_x_);
+  for (size_t k = 0; k < in_.size(); ++k) {
+    if (in_[k].type == InputType::REG) {
+      const double* a = arg[k];
+      for (size_t i = 0; i < fmu_.ired(in_[k].ind).size(); ++i) {
+        double v = a ? a[i] : 0;
+        if (*x != v) {
+          *x = v;
+          same = false;
+        }
+        x++;
+      }
+    }
+  }
+  // Invalidate cached derivatives if the point has changed
+  if (!same) m->cache_jac_valid_ = m->cache_hess_valid_ = false;
+  return same;
+}
+
+void FmuFunction::jac_adj(const double* jac_nz, const double* aseed, double* asens) const {
+  // Extended Jacobian sparsity
+  casadi_int n = jac_sp_.size2();
+  const casadi_int *colind = jac_sp_.colind(), *row = jac_sp_.row();
+  // Loop over Jacobian columns
+  for (casadi_int c = 0; c < n; ++c) {
+    // Corresponding input in Fmu
+    size_t id_c = jac_in_[c];
+    // Add contribution from each nonzero
+    for (casadi_int k = colind[c]; k < colind[c + 1]; ++k) {
+      asens[id_c] += aseed[jac_out_[row[k]]] * jac_nz[k];
+    }
+  }
+}
+
 void FmuFunction::check_hessian(FmuMemory* m, const double *hess_nz, casadi_int* iw) const {
   // Get Hessian sparsity pattern
   casadi_int n = hess_sp_.size1();
@@ -1323,6 +1426,7 @@ Function FmuFunction::factory(const std::string& name,
     opts1["parallelization"] = to_string(parallelization_);
     opts1["verbose"] = verbose_;
     opts1["print_progress"] = print_progress_;
+    opts1["cache_derivatives"] = cache_derivatives_;
     // Replace ':' with '_' in s_in and s_out
     std::vector<std::string> s_in_mod = s_in, s_out_mod = s_out;
     for (std::string& s : s_in_mod) std::replace(s.begin(), s.end(), ':', '_');
@@ -1354,6 +1458,7 @@ Function FmuFunction::get_jacobian(const std::string& name, const std::vector<st
   opts1["parallelization"] = to_string(parallelization_);
   opts1["verbose"] = verbose_;
   opts1["print_progress"] = print_progress_;
+  opts1["cache_derivatives"] = cache_derivatives_;
   // Return new instance of class
   Function ret;
   ret.own(new FmuFunction(name, fmu_, inames, onames));
@@ -1385,6 +1490,7 @@ Function FmuFunction::get_forward(casadi_int nfwd, const std::string& name,
   opts1["parallelization"] = to_string(parallelization_);
   opts1["verbose"] = verbose_;
   opts1["print_progress"] = print_progress_;
+  opts1["cache_derivatives"] = cache_derivatives_;
   // Return new instance of class
   Function ret;
   ret.own(new FmuFunction(name, fmu_, inames, onames));
@@ -1411,6 +1517,7 @@ Function FmuFunction::get_reverse(casadi_int nadj, const std::string& name,
   opts1["verbose"] = verbose_;
   opts1["new_jacobian"] = new_hessian_;
   opts1["print_progress"] = print_progress_;
+  opts1["cache_derivatives"] = cache_derivatives_;
   // Return new instance of class
   Function ret;
   ret.own(new FmuFunction(name, fmu_, inames, onames));
@@ -1471,7 +1578,7 @@ Dict FmuFunction::get_stats(void *mem) const {
 
 void FmuFunction::serialize_body(SerializingStream &s) const {
   FunctionInternal::serialize_body(s);
-  s.version("FmuFunction", 2);
+  s.version("FmuFunction", 3);
 
   s.pack("FmuFunction::Fmu", fmu_);
 
@@ -1513,6 +1620,7 @@ void FmuFunction::serialize_body(SerializingStream &s) const {
   s.pack("FmuFunction::new_forward", new_forward_);
   s.pack("FmuFunction::new_hessian", new_hessian_);
   s.pack("FmuFunction::hessian_coloring", hessian_coloring_);
+  s.pack("FmuFunction::cache_derivatives", cache_derivatives_);
   s.pack("FmuFunction::validate_ad_file", validate_ad_file_);
 
   s.pack("FmuFunction::fd", static_cast<int>(fd_));
@@ -1533,7 +1641,7 @@ void FmuFunction::serialize_body(SerializingStream &s) const {
 }
 
 FmuFunction::FmuFunction(DeserializingStream& s) : FunctionInternal(s) {
-  int version = s.version("FmuFunction", 1, 2);
+  int version = s.version("FmuFunction", 1, 3);
 
   s.unpack("FmuFunction::Fmu", fmu_);
 
@@ -1581,6 +1689,11 @@ FmuFunction::FmuFunction(DeserializingStream& s) : FunctionInternal(s) {
   if (version >= 2) s.unpack("FmuFunction::new_forward", new_forward_);
   s.unpack("FmuFunction::new_hessian", new_hessian_);
   s.unpack("FmuFunction::hessian_coloring", hessian_coloring_);
+  if (version >= 3) {
+    s.unpack("FmuFunction::cache_derivatives", cache_derivatives_);
+  } else {
+    cache_derivatives_ = false;
+  }
   s.unpack("FmuFunction::validate_ad_file", validate_ad_file_);
 
   int fd = 0;
@@ -53,12 +53,18 @@ struct CASADI_EXPORT FmuMemory : public FunctionMemory {
   double *jac_nz;
   // Extended Hessian
   double *hess_nz;
+  // Cached extended Jacobian, cached perturbed extended Jacobians for each Hessian color
+  double *jac_cache, *hess_cache;
+  // Read perturbed extended Jacobians from the cache instead of evaluating the FMU
+  bool use_hess_cache;
   // Adjoint seeds, sensitivities being calculated
   double *aseed, *asens, *pert_asens;
   // Memory for Jacobian calculation
   casadi_jac_data<double> d;
   // Instance memory
   void* instance;
+  // Snapshot of the instance state after initialization, if any
+  void* instance_state;
   // Additional (slave) memory objects
   std::vector<FmuMemory*> slaves;
   // Input and output buffers
@@ -69,6 +75,10 @@ struct CASADI_EXPORT FmuMemory : public FunctionMemory {
   std::vector<bool> changed_;
   // Which entries are being requested
   std::vector<bool> requested_;
+  // Changed inputs, requested outputs since the last evaluation
+  std::vector<size_t> pending_in_, pending_out_;
+  // Position of an input in id_in_
+  std::vector<size_t> pos_in_;
   // Derivative with respect to
   std::vector<size_t> wrt_;
   // Current known/unknown variables
@@ -81,8 +91,30 @@ struct CASADI_EXPORT FmuMemory : public FunctionMemory {
   std::vector<unsigned int> vr_in_, vr_out_;
   // Work vector (reals)
   std::vector<double> v_in_, v_out_, d_in_, d_out_, fd_out_, v_pert_;
+  // Regular input values for which the cached derivatives were calculated
+  std::vector<double> cache_x_;
+  // Storage for cached derivatives
+  std::vector<double> cache_jac_, cache_hess_;
+  // Are the cached derivatives valid?
+  bool cache_jac_valid_, cache_hess_valid_;
   // Constructor
-  explicit FmuMemory(const FmuFunction& self) : self(self), instance(nullptr) {}
+  explicit FmuMemory(const FmuFunction& self) : self(self), jac_cache(nullptr),
+    hess_cache(nullptr), use_hess_cache(false), instance(nullptr), instance_state(nullptr),
+    cache_jac_valid_(false), cache_hess_valid_(false) {}
+  // Mark an input as changed
+  void mark_changed(size_t id) {
+    if (!changed_.at(id)) {
+      changed_[id] = true;
+      pending_in_.push_back(id);
+    }
+  }
+  // Mark an output as requested
+  void mark_requested(size_t id) {
+    if (!requested_.at(id)) {
+      requested_[id] = true;
+      pending_out_.push_back(id);
+    }
+  }
 };
 
 /// Type of parallelization
@@ -161,6 +193,7 @@ class CASADI_EXPORT FmuFunction : public FunctionInternal {
   bool enable_ad_, validate_ad_, make_symmetric_, check_hessian_;
   double step_, abstol_, reltol_;
   bool print_progress_, new_jacobian_, new_forward_, new_hessian_, hessian_coloring_;
+  bool cache_derivatives_;
   std::string validate_ad_file_;
 
   // FD method as an enum
@@ -257,6 +290,12 @@ class CASADI_EXPORT FmuFunction : public FunctionInternal {
   int eval_task(FmuMemory* m, casadi_int task, casadi_int n_task,
     bool need_nondiff, bool need_jac, bool need_fwd, bool need_adj, bool need_hess) const;
 
+  // Check if the regular inputs match the point of the cached derivatives, update if not
+  bool same_point(FmuMemory* m, const double** arg) const;
+
+  // Get adjoint sensitivities from (cached) extended Jacobian nonzeros
+  void jac_adj(const double* jac_nz, const double* aseed, double* asens) const;
+
   // Remove NaNs from Hessian (necessary for star coloring approach)
   void remove_nans(double *hess_nz, casadi_int* iw) const;
 
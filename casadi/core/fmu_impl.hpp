@@ -29,6 +29,14 @@
 #include "importer.hpp"
 #include "shared_object_internal.hpp"
 
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif //CASADI_WITH_THREAD
+
 /// \cond INTERNAL
 
 namespace casadi {
@@ -52,7 +60,8 @@ class CASADI_EXPORT FmuInternal : public SharedObjectInternal {
   // Constructor
   FmuInternal(const std::string& name,
     const std::vector<std::string>& scheme_in, const std::vector<std::string>& scheme_out,
-    const std::map<std::string, std::vector<size_t>>& scheme, const std::vector<std::string>& aux);
+    const std::map<std::string, std::vector<size_t>>& scheme, const std::vector<std::string>& aux,
+    casadi_int instance_pool_size);
 
   /// Destructor
   ~FmuInternal() override;
@@ -116,6 +125,24 @@ class CASADI_EXPORT FmuInternal : public SharedObjectInternal {
   // Free FMU instance
   virtual void free_instance(void* c) const = 0;
 
+  // Create and initialize a new FMU instance
+  virtual int init_instance(FmuMemory* m) const = 0;
+
+  // Bring a previously used FMU instance back to its initialized state
+  virtual int restore_instance(FmuMemory* m) const = 0;
+
+  // Free a snapshot of the FMU state
+  virtual void free_state(void* c, void* s) const = 0;
+
+  // Get an initialized FMU instance, reusing one from the pool if possible
+  int checkout_instance(FmuMemory* m) const;
+
+  // Return an FMU instance to the pool, free it if the pool is full
+  void release_instance(FmuMemory* m) const;
+
+  // Free all FMU instances in the pool
+  void clear_pool();
+
   // Set value
   void set(FmuMemory* m, size_t ind, const double* value) const;
 
@@ -211,6 +238,17 @@ class CASADI_EXPORT FmuInternal : public SharedObjectInternal {
 
   // Sparsity pattern for extended Jacobian, Hessian
   Sparsity jac_sp_, hess_sp_;
+
+  // Maximum number of idle FMU instances kept for reuse
+  casadi_int instance_pool_size_;
+
+  // Idle FMU instances, with snapshots of their initialized state (if any)
+  mutable std::vector<std::pair<void*, void*>> pool_;
+
+#ifdef CASADI_WITH_THREAD
+  /// Mutex for thread safe access to the pool
+  mutable std::mutex pool_mtx_;
+#endif // CASADI_WITH_THREAD
 };
 
 template<typename T>
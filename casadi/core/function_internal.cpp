@@ -42,6 +42,7 @@
 #include "integrator_impl.hpp"
 #include "external_impl.hpp"
 #include "fmu_function.hpp"
+#include "edge_pushing.hpp"
 
 #include <cctype>
 #include <typeinfo>
@@ -126,6 +127,14 @@ namespace casadi {
       std::string jit_directory = get_from_dict(jit_options_, "directory", std::string(""));
       std::string jit_name = jit_directory + jit_name_ + ".c";
       if (remove(jit_name.c_str())) casadi_warning("Failed to remove " + jit_name);
+      // Additional files when the code was split, kept if incremental
+      if (get_from_dict(jit_options_, "split", casadi_int(0))
+          && !get_from_dict(jit_options_, "incremental", false)) {
+        for (casadi_int i=1; ; ++i) {
+          jit_name = jit_directory + jit_name_ + "_" + str(i) + ".c";
+          if (remove(jit_name.c_str())) break;
+        }
+      }
     }
   }
 
@@ -251,7 +260,10 @@ namespace casadi {
         "Just-in-time compiler plugin to be used."}},
       {"jit_options",
        {OT_DICT,
-        "Options to be passed to the jit compiler."}},
+        "Options to be passed to the jit compiler. "
+        "The entry 'split' is passed to the code generator instead: "
+        "the code is split across files of about this many bytes, "
+        "which the 'shell' compiler compiles in parallel."}},
       {"derivative_of",
        {OT_FUNCTION,
         "The function is a derivative of another function. "
@@ -689,14 +701,14 @@ namespace casadi {
         if (compiler_.is_null()) {
           if (verbose_) casadi_message("Codegenerating function '" + name_ + "'.");
           // JIT everything
-          Dict opts;
+          Dict opts = jit_codegen_options();
           // Override the default to avoid random strings in the generated code
           opts["prefix"] = "jit";
           CodeGenerator gen(jit_name_, opts);
           gen.add(self());
           if (verbose_) casadi_message("Compiling function '" + name_ + "'..");
           std::string jit_directory = get_from_dict(jit_options_, "directory", std::string(""));
-          compiler_ = Importer(gen.generate(jit_directory), compiler_plugin_, jit_options_);
+          compiler_ = jit_compile(gen, jit_directory);
           if (verbose_) casadi_message("Compiling function '" + name_ + "' done.");
         }
         // Try to load
@@ -2280,7 +2292,9 @@ namespace casadi {
   void FunctionInternal::codegen(CodeGenerator& g, const std::string& fname) const {
     // Define function
     g << "/* " << definition() << " */\n";
-    g << "static " << signature(fname) << " {\n";
+    // Functions may be called from other translation units when splitting
+    if (!g.split && !g.incremental) g << "static ";
+    g << g.shared_symbol() << signature(fname) << " {\n";
 
     // Reset local variables, flush buffer
     g.flush(g.body);
@@ -2329,13 +2343,54 @@ namespace casadi {
     bool needs_mem = !codegen_mem_type().empty();
     if (needs_mem) {
     std::string name = codegen_name(g, false);
+    if (g.mem_pool) {
+      // Claim a free pool entry, returned to the pool by free_mem
+      std::string busy = g.shorthand(name + "_busy");
+      std::string ready = g.shorthand(name + "_ready");
+      g << "int mid;\n";
+      g << "for (mid=0; mid<CASADI_MAX_NUM_THREADS; ++mid) {\n";
+      g << "if (casadi_pool_acquire(" << busy << "+mid)) {\n";
+      g << ready << "[mid] = 0;\n";
+      g << "return mid;\n";
+      g << "}\n";
+      g << "}\n";
+      g << "return -1;\n";
+      return;
+    }
     std::string mem_counter = g.shorthand(name + "_mem_counter");
+    g << "if (" << mem_counter << "==CASADI_MAX_NUM_THREADS) return -1;\n";
     g << "return " + mem_counter + "++;\n";
     }
   }
 
   void FunctionInternal::codegen_checkout(CodeGenerator& g) const {
     std::string name = codegen_name(g, false);
+    if (g.mem_pool) {
+      // Fixed-capacity pool, entries claimed with an atomic compare-and-swap
+      std::string busy = g.shorthand(name + "_busy");
+      std::string ready = g.shorthand(name + "_ready");
+      std::string mem_array = g.shorthand(name + "_mem");
+      std::string init_mem = g.shorthand(name + "_init_mem");
+      g.auxiliaries << "static volatile long " << busy << "[CASADI_MAX_NUM_THREADS];\n";
+      g.auxiliaries << "static int " << ready << "[CASADI_MAX_NUM_THREADS];\n";
+      g.auxiliaries << "static " << codegen_mem_type() <<
+                 " " << mem_array << "[CASADI_MAX_NUM_THREADS];\n\n";
+      g << "int mid;\n";
+      g << "for (mid=0; mid<CASADI_MAX_NUM_THREADS; ++mid) {\n";
+      g << "if (casadi_pool_acquire(" << busy << "+mid)) {\n";
+      g << "if (!" << ready << "[mid]) {\n";
+      g << "if (" << init_mem << "(mid)) {\n";
+      g << "casadi_pool_release(" << busy << "+mid);\n";
+      g << "return -1;\n";
+      g << "}\n";
+      g << ready << "[mid] = 1;\n";
+      g << "}\n";
+      g << "return mid;\n";
+      g << "}\n";
+      g << "}\n";
+      g << "return -1;\n";
+      return;
+    }
     std::string stack_counter = g.shorthand(name + "_unused_stack_counter");
     std::string stack = g.shorthand(name + "_unused_stack");
     std::string mem_counter = g.shorthand(name + "_mem_counter");
@@ -2352,7 +2407,6 @@ namespace casadi {
     g << "if (" << stack_counter << ">=0) {\n";
     g << "return " << stack << "[" << stack_counter << "--];\n";
     g << "} else {\n";
-    g << "if (" << mem_counter << "==CASADI_MAX_NUM_THREADS) return -1;\n";
     g << "mid = " << alloc_mem << "();\n";
     g << "if (mid<0) return -1;\n";
     g << "if(" << init_mem << "(mid)) return -1;\n";
@@ -2362,6 +2416,10 @@ namespace casadi {
 
   void FunctionInternal::codegen_release(CodeGenerator& g) const {
     std::string name = codegen_name(g, false);
+    if (g.mem_pool) {
+      g << "casadi_pool_release(" << g.shorthand(name + "_busy") << "+mem);\n";
+      return;
+    }
     std::string stack_counter = g.shorthand(name + "_unused_stack_counter");
     std::string stack = g.shorthand(name + "_unused_stack");
     g << stack << "[++" << stack_counter << "] = mem;\n";
@@ -2393,6 +2451,8 @@ namespace casadi {
     g << g.declare("void " + name_ + "_free_mem(int mem)") << " {\n";
     if (needs_mem) {
       g << codegen_name(g) << "_free_mem(mem);\n";
+      // Return the entry claimed by alloc_mem to the pool
+      if (g.mem_pool) g << codegen_name(g) << "_release(mem);\n";
     }
     g << "}\n\n";
 
@@ -2459,8 +2519,10 @@ namespace casadi {
     codegen_sparsities(g);
 
     // Determine work vector size
-    casadi_int sz_w_codegen = sz_w();
-    if (is_a("SXFunction", true) && !g.avoid_stack()) sz_w_codegen = 0;
+    casadi_int sz_w_codegen = codegen_sz_w(g);
+    if (is_a("SXFunction", true) && !g.avoid_stack() && !g.reroll && !g.split) {
+      sz_w_codegen = 0;
+    }
 
     // Function that returns work vector lengths
     g << g.declare(
@@ -2492,7 +2554,7 @@ namespace casadi {
         << "#define " << name_ << "_SZ_ARG " << sz_arg() << "\n"
         << "#define " << name_ << "_SZ_RES " << sz_res() << "\n"
         << "#define " << name_ << "_SZ_IW " << sz_iw() << "\n"
-        << "#define " << name_ << "_SZ_W " << sz_w() << "\n";
+        << "#define " << name_ << "_SZ_W " << codegen_sz_w(g) << "\n";
      }
 
     // Which inputs are differentiable
@@ -2529,7 +2591,7 @@ namespace casadi {
       g << "int mem;\n";
       // Work vectors, including input and output buffers
       casadi_int i_nnz = nnz_in(), o_nnz = nnz_out();
-      size_t sz_w = this->sz_w();
+      size_t sz_w = codegen_sz_w(g);
       for (casadi_int i=0; i<n_in_; ++i) {
         const Sparsity& s = sparsity_in_[i];
         sz_w = std::max(sz_w, static_cast<size_t>(s.size1())); // To be able to copy a column
@@ -2609,7 +2671,7 @@ namespace casadi {
 
 
       // Work vectors and input and output buffers
-      size_t nr = sz_w() + nnz_in() + nnz_out();
+      size_t nr = codegen_sz_w(g) + nnz_in() + nnz_out();
       g << CodeGenerator::array("casadi_int", "iw", sz_iw())
         << CodeGenerator::array("casadi_real", "w", nr);
 
@@ -2724,6 +2786,27 @@ namespace casadi {
     g << "#error Code generation not supported for " << class_name() << "\n";
   }
 
+  Dict FunctionInternal::jit_codegen_options() const {
+    Dict opts;
+    auto it = jit_options_.find("split");
+    if (it!=jit_options_.end()) opts["split"] = it->second;
+    it = jit_options_.find("incremental");
+    if (it!=jit_options_.end()) opts["incremental"] = it->second;
+    return opts;
+  }
+
+  Importer FunctionInternal::jit_compile(CodeGenerator& gen, const std::string& prefix) const {
+    std::string fname = gen.generate(prefix);
+    // Compiler options, with any split-off source files
+    Dict opts = jit_options_;
+    opts.erase("split");
+    opts.erase("incremental");
+    if (!gen.split_files.empty()) opts["extra_sources"] = gen.split_files;
+    // Reuse the objects of unchanged source files
+    if (gen.incremental && compiler_plugin_=="shell") opts["incremental"] = true;
+    return Importer(fname, compiler_plugin_, opts);
+  }
+
   std::string FunctionInternal::
   generate_dependencies(const std::string& fname, const Dict& opts) const {
     casadi_error("'generate_dependencies' not defined for " + class_name());
@@ -4061,6 +4144,7 @@ namespace casadi {
     {"External", External::deserialize},
     {"Conic", Conic::deserialize},
     {"FmuFunction", FmuFunction::deserialize},
+    {"EdgePushing", EdgePushing::deserialize},
   };
 
 } // namespace casadi
@@ -879,6 +879,12 @@ namespace casadi {
         \identifier{m4} */
     virtual void jit_dependencies(const std::string& fname) {}
 
+    /** \brief Code generation options for just-in-time compilation */
+    Dict jit_codegen_options() const;
+
+    /** \brief Write generated code and compile it with the jit compiler */
+    Importer jit_compile(CodeGenerator& gen, const std::string& prefix) const;
+
     /** \brief Export function in a specific language
 
         \identifier{m5} */
@@ -1147,6 +1153,9 @@ namespace casadi {
         \identifier{n3} */
     size_t sz_w() const { return sz_w_per_ + sz_w_tmp_;}
 
+    /** \brief Get required length of w field in generated code */
+    virtual size_t codegen_sz_w(const CodeGenerator& g) const { return sz_w();}
+
     /** \brief Ensure required length of arg field
 
         \identifier{n4} */
@@ -491,15 +491,43 @@ namespace casadi {
   void GetNonzerosVector::generate(CodeGenerator& g,
                                     const std::vector<casadi_int>& arg,
                                     const std::vector<casadi_int>& res) const {
-    // Codegen the indices
-    std::string ind = g.constant(nz_);
-
-    // Codegen the assignments
     g.local("cii", "const casadi_int", "*");
     g.local("rr", "casadi_real", "*");
     g.local("ss", "casadi_real", "*");
-    g << "for (cii=" << ind << ", rr=" << g.work(res[0], nnz())
-      << ", ss=" << g.work(arg[0], dep(0).nnz())
+
+    // Indices relative to the smallest one, shared between tables differing by an offset
+    casadi_int offset = 0;
+    if (g.compress && !nz_.empty() && !has_negative(nz_)) {
+      offset = *std::min_element(nz_.begin(), nz_.end());
+    }
+    std::vector<casadi_int> nz = nz_;
+    for (casadi_int& e : nz) e -= offset;
+    std::string ss = g.work(arg[0], dep(0).nnz());
+    if (offset) ss += "+" + str(offset);
+
+    // Codegen runs of constant stride, if shorter than the indices
+    if (g.compress) {
+      std::vector<casadi_int> runs = CodeGenerator::index_runs(nz);
+      if (runs.size()<nz.size()) {
+        std::string ind = g.constant(runs);
+        g.local("i", "casadi_int");
+        g << "for (cii=" << ind << ", rr=" << g.work(res[0], nnz()) << ", ss=" << ss
+          << "; cii!=" << ind << "+" << runs.size()
+          << "; cii+=3) for (i=0; i<cii[2]; ++i) *rr++ = ";
+        if (has_negative(nz_)) {
+          g << "cii[0]>=0 ? ss[cii[0]+i*cii[1]] : 0;\n";
+        } else {
+          g << "ss[cii[0]+i*cii[1]];\n";
+        }
+        return;
+      }
+    }
+
+    // Codegen the indices
+    std::string ind = g.constant(nz);
+
+    // Codegen the assignments
+    g << "for (cii=" << ind << ", rr=" << g.work(res[0], nnz()) << ", ss=" << ss
       << "; cii!=" << ind << "+" << nz_.size()
       << "; ++cii) *rr++ = ";
     if (has_negative(nz_)) {
@@ -118,6 +118,9 @@ namespace casadi {
     clear_mem();
   }
 
+  // Largest work vector of a batch of instances in generated code
+  static const casadi_int max_simd_work = 16384;
+
   void Map::init(const Dict& opts) {
     is_diff_in_ = f_.is_diff_in();
     is_diff_out_ = f_.is_diff_out();
@@ -176,10 +179,31 @@ namespace casadi {
   }
 
   void Map::codegen_declarations(CodeGenerator& g) const {
-    g.add_dependency(f_);
+    if (codegen_n_simd(g)<n_) g.add_dependency(f_);
+  }
+
+  casadi_int Map::codegen_n_simd(const CodeGenerator& g) const {
+    // Batched evaluation, maps over SX functions generated serially only
+    if (g.simd && !is_a("OmpMap", false) && f_.is_a("SXFunction")
+        && g.simd*f_.sz_w()<=max_simd_work) {
+      return n_ - n_ % g.simd;
+    }
+    return 0;
+  }
+
+  size_t Map::codegen_sz_w(const CodeGenerator& g) const {
+    size_t sz = std::max(sz_w(), f_->codegen_sz_w(g));
+    // Work vector of a batch
+    if (codegen_n_simd(g)>0) sz = std::max(sz, static_cast<size_t>(g.simd*f_.sz_w()));
+    return sz;
   }
 
   void Map::codegen_body(CodeGenerator& g) const {
+    // Instances evaluated in batches
+    casadi_int n_simd = codegen_n_simd(g);
+    if (n_simd>0) codegen_simd(g, n_simd);
+    if (n_simd==n_) return;
+
     g.local("i", "casadi_int");
     g.local("arg1", "const casadi_real*", "*");
     g.local("res1", "casadi_real*", "*");
@@ -189,8 +213,19 @@ namespace casadi {
       << "for (i=0; i<" << n_in_ << "; ++i) arg1[i]=arg[i];\n";
     // Output buffer
     g << "res1 = res+" << n_out_ << ";\n"
-      << "for (i=0; i<" << n_out_ << "; ++i) res1[i]=res[i];\n"
-      << "for (i=0; i<" << n_ << "; ++i) {\n";
+      << "for (i=0; i<" << n_out_ << "; ++i) res1[i]=res[i];\n";
+    // Skip the instances already evaluated
+    if (n_simd>0) {
+      for (casadi_int j=0; j<n_in_; ++j) {
+        if (f_.nnz_in(j))
+          g << "if (arg1[" << j << "]) arg1[" << j << "]+=" << n_simd*f_.nnz_in(j) << ";\n";
+      }
+      for (casadi_int j=0; j<n_out_; ++j) {
+        if (f_.nnz_out(j))
+          g << "if (res1[" << j << "]) res1[" << j << "]+=" << n_simd*f_.nnz_out(j) << ";\n";
+      }
+    }
+    g << "for (i=0; i<" << n_-n_simd << "; ++i) {\n";
     // Evaluate
     g << "if (" << g(f_, "arg1", "res1", "iw", "w") << ") return 1;\n";
     // Update input buffers
@@ -206,6 +241,45 @@ namespace casadi {
     g << "}\n";
   }
 
+  void Map::codegen_simd(CodeGenerator& g, casadi_int n) const {
+    casadi_int W = g.simd;
+    g.local("i", "casadi_int");
+    g.local("k", "casadi_int");
+    // Work vector element el for instance i+k
+    auto ws = [&](casadi_int el) { return "w[" + str(el*W) + "+k]"; };
+    // Loop over the batch
+    std::string batch = "#pragma omp simd\nfor (k=0; k<" + str(W) + "; ++k) ";
+
+    g << "for (i=0; i<" << n << "; i+=" << W << ") {\n";
+    for (casadi_int k=0; k<f_.n_instructions(); ++k) {
+      casadi_int op = f_.instruction_id(k);
+      std::vector<casadi_int> o = f_.instruction_output(k);
+      std::vector<casadi_int> i = f_.instruction_input(k);
+      switch (op) {
+        case OP_INPUT:
+          g << batch << ws(o[0]) << "=" << g.arg(i[0]) << " ? "
+            << g.arg(i[0]) << "[(i+k)*" << f_.nnz_in(i[0]) << "+" << i[1] << "] : 0;\n";
+          break;
+        case OP_OUTPUT:
+          g << "if (" << g.res(o[0]) << ") {\n"
+            << batch << g.res(o[0]) << "[(i+k)*" << f_.nnz_out(o[0]) << "+" << o[1] << "]="
+            << ws(i[0]) << ";\n"
+            << "}\n";
+          break;
+        case OP_CONST:
+          g << batch << ws(o[0]) << "=" << g.constant(f_.instruction_constant(k)) << ";\n";
+          break;
+        default:
+          if (i.size()==1) {
+            g << batch << ws(o[0]) << "=" << g.print_op(op, ws(i[0])) << ";\n";
+          } else {
+            g << batch << ws(o[0]) << "=" << g.print_op(op, ws(i[0]), ws(i[1])) << ";\n";
+          }
+      }
+    }
+    g << "}\n";
+  }
+
   Function Map
   ::get_forward(casadi_int nfwd, const std::string& name,
                 const std::vector<std::string>& inames,
@@ -373,9 +447,14 @@ namespace casadi {
 #endif  // WITH_OPENMP
   }
 
+  size_t OmpMap::codegen_sz_w(const CodeGenerator& g) const {
+    return f_->codegen_sz_w(g) * n_;
+  }
+
   void OmpMap::codegen_body(CodeGenerator& g) const {
     size_t sz_arg, sz_res, sz_iw, sz_w;
     f_.sz_work(sz_arg, sz_res, sz_iw, sz_w);
+    sz_w = f_->codegen_sz_w(g);
     g << "casadi_int i;\n"
       << "const double** arg1;\n"
       << "double** res1;\n"
@@ -149,6 +149,20 @@ namespace casadi {
         \identifier{hf} */
     void codegen_body(CodeGenerator& g) const override;
 
+    /** \brief Generate code for the first n instances, in batches
+
+        Each SX work vector element is stored in w for a batch of instances,
+        so that every instruction can be vectorized across the batch.
+        The work vector is only sized for a batch in generated code, see codegen_sz_w.
+    */
+    void codegen_simd(CodeGenerator& g, casadi_int n) const;
+
+    /** \brief Number of instances generated in batches */
+    casadi_int codegen_n_simd(const CodeGenerator& g) const;
+
+    /** \brief Get required length of w field in generated code */
+    size_t codegen_sz_w(const CodeGenerator& g) const override;
+
     /** \brief  Initialize
 
         \identifier{hg} */
@@ -258,6 +272,9 @@ namespace casadi {
         \identifier{hs} */
     void codegen_body(CodeGenerator& g) const override;
 
+    /** \brief Get required length of w field in generated code */
+    size_t codegen_sz_w(const CodeGenerator& g) const override;
+
   protected:
     /** \brief Deserializing constructor
 
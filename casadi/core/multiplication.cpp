@@ -143,6 +143,14 @@ namespace casadi {
                           g.work(res[0], nnz())) << '\n';
     }
 
+    // Unrolled or with contiguous innermost loop
+    if (g.specialize) {
+      g << g.mtimes(g.work(arg[1], dep(1).nnz()), dep(1).sparsity(),
+                    g.work(arg[2], dep(2).nnz()), dep(2).sparsity(),
+                    g.work(res[0], nnz()), sparsity(), "w", false) << '\n';
+      return;
+    }
+
     casadi_int nrow_x = dep(1).size1(), nrow_y = dep(2).size1(), ncol_y = dep(2).size2();
     g.local("rr", "casadi_real", "*");
     g.local("ss", "casadi_real", "*");
@@ -1160,10 +1160,94 @@ namespace casadi {
                    + str(free_vars_) + " are free.");
     }
 
+    // Calls replaced by fused functions
+    std::vector<bool> fused(algorithm_.size(), false);
+    for (auto&& gr : codegen_fused(g)) {
+      for (casadi_int k : gr.first) fused[k] = true;
+      g.add_dependency(gr.second);
+    }
+
     // Generate code for the embedded functions
-    for (auto&& a : algorithm_) {
-      a.data->add_dependency(g);
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      if (!fused[k]) algorithm_[k].data->add_dependency(g);
+    }
+  }
+
+  std::vector<std::pair<std::vector<casadi_int>, Function> >
+  MXFunction::codegen_fused(CodeGenerator& g) const {
+    std::vector<std::pair<std::vector<casadi_int>, Function> > ret;
+    if (!g.fuse || g.avoid_stack()) return ret;
+
+    // Space for the work vectors of the called functions
+    casadi_int sz_w_call = sz_w();
+    for (casadi_int w : workloc_) sz_w_call = std::min(sz_w_call, w);
+
+    // Group calls to SX functions by their argument expressions
+    std::map<std::vector<const MXNode*>, std::vector<casadi_int> > groups;
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      const AlgEl& e = algorithm_[k];
+      if (e.op!=OP_CALL) continue;
+      const Function& f = e.data->which_function();
+      if (!f.is_a("SXFunction") || f.has_free()) continue;
+      std::vector<const MXNode*> key;
+      for (casadi_int i=0; i<e.data->n_dep(); ++i) key.push_back(e.data->dep(i).get());
+      groups[key].push_back(k);
+    }
+
+    for (auto&& gr : groups) {
+      // Calls evaluated together, with matching input sparsities
+      std::vector<casadi_int> ind;
+      const Function& f0 = algorithm_[gr.second.front()].data->which_function();
+      for (casadi_int k : gr.second) {
+        const Function& f = algorithm_[k].data->which_function();
+        bool match = true;
+        for (casadi_int i=0; match && i<f.n_in(); ++i) {
+          match = f.sparsity_in(i)==f0.sparsity_in(i);
+        }
+        if (match) ind.push_back(k);
+      }
+      if (ind.size()<2) continue;
+
+      // Function evaluating all outputs, created once
+      Function fused;
+      std::string fname = name_ + "_fused" + str(ind.front());
+      if (!incache(fname, fused)) {
+        std::vector<SX> in = f0.sx_in(), out;
+        for (casadi_int k : ind) {
+          std::vector<SX> r = algorithm_[k].data->which_function()(in);
+          out.insert(out.end(), r.begin(), r.end());
+        }
+        fused = Function(fname, in, SX::cse(out));
+        tocache(fused);
+      }
+
+      // Work vector elements are only used when not declared as local variables
+      if ((g.reroll || g.split) && fused.sz_w()>sz_w_call) continue;
+      ret.push_back(std::make_pair(ind, fused));
+    }
+
+    // Order of the first call
+    std::sort(ret.begin(), ret.end(),
+      [](const std::pair<std::vector<casadi_int>, Function>& a,
+         const std::pair<std::vector<casadi_int>, Function>& b) { return a.first<b.first;});
+    return ret;
+  }
+
+  size_t MXFunction::codegen_sz_w(const CodeGenerator& g) const {
+    // Space for the work vectors of the called functions, numeric and generated
+    size_t sz_call = sz_w();
+    for (casadi_int w : workloc_) sz_call = std::min(sz_call, static_cast<size_t>(w));
+    size_t sz_call_codegen = sz_call;
+    for (auto&& e : algorithm_) {
+      if (e.op==OP_OUTPUT) continue;
+      for (casadi_int c : e.res) {
+        if (c>=0) {
+          sz_call_codegen = std::max(sz_call_codegen, e.data->codegen_sz_w(g));
+          break;
+        }
+      }
     }
+    return sz_w() + sz_call_codegen - sz_call;
   }
 
   void MXFunction::codegen_incref(CodeGenerator& g) const {
@@ -1186,6 +1270,7 @@ namespace casadi {
     g.init_local("res1", "res+" + str(n_out_));
 
     // Declare scalar work vector elements as local variables
+    casadi_int w_shift = codegen_sz_w(g) - sz_w();
     bool first = true;
     for (casadi_int i=0; i<workloc_.size()-1; ++i) {
       casadi_int n=workloc_[i+1]-workloc_[i];
@@ -1206,11 +1291,34 @@ namespace casadi {
       if (!g.codegen_scalars && n==1) {
         g << "w" << i;
       } else {
-        g << "*w" << i << "=w+" << workloc_[i];
+        g << "*w" << i << "=w+" << workloc_[i] + w_shift;
       }
     }
     if (!first) g << ";\n";
 
+    // Fused calls: outputs of the later calls are held until their turn
+    std::vector<std::pair<std::vector<casadi_int>, Function> > fused = codegen_fused(g);
+    std::map<casadi_int, std::pair<casadi_int, casadi_int> > fused_loc;
+    std::map<std::pair<casadi_int, casadi_int>, std::string> held;
+    casadi_int sz_hres = 0;
+    for (casadi_int r=0; r<fused.size(); ++r) {
+      sz_hres = std::max(sz_hres, fused[r].second.n_out());
+      const std::vector<casadi_int>& ind = fused[r].first;
+      for (casadi_int m=0; m<ind.size(); ++m) {
+        fused_loc[ind[m]] = std::make_pair(r, m);
+        if (m==0) continue;
+        const AlgEl& e = algorithm_[ind[m]];
+        for (casadi_int i=0; i<e.res.size(); ++i) {
+          casadi_int j = e.res[i], n = e.data->sparsity(i).nnz();
+          if (j<0 || workloc_.at(j)==workloc_.at(j+1) || n==0) continue;
+          std::string name = "h" + str(held.size());
+          held[std::make_pair(ind[m], i)] = name;
+          g << "casadi_real " << name << "[" << n << "];\n";
+        }
+      }
+    }
+    if (sz_hres>0) g << "casadi_real *hres[" << sz_hres << "];\n";
+
     // Operation number (for printing)
     casadi_int k=0;
 
@@ -1247,7 +1355,38 @@ namespace casadi {
       }
 
       // Generate operation
-      e.data->generate(g, arg, res);
+      auto it = fused_loc.find(&e-algorithm_.data());
+      if (it==fused_loc.end()) {
+        e.data->generate(g, arg, res);
+      } else if (it->second.second==0) {
+        // Evaluate all calls in the group
+        const std::vector<casadi_int>& ind = fused[it->second.first].first;
+        const Function& f = fused[it->second.first].second;
+        g.local("arg1", "const casadi_real", "**");
+        for (casadi_int i=0; i<arg.size(); ++i) {
+          g << "arg1[" << i << "]=" << g.work(arg[i], f.nnz_in(i)) << ";\n";
+        }
+        for (casadi_int i=0; i<res.size(); ++i) {
+          g << "hres[" << i << "]=" << g.work(res[i], f.nnz_out(i)) << ";\n";
+        }
+        casadi_int i1 = res.size();
+        for (casadi_int m=1; m<ind.size(); ++m) {
+          const AlgEl& e1 = algorithm_[ind[m]];
+          for (casadi_int i=0; i<e1.res.size(); ++i) {
+            auto h = held.find(std::make_pair(ind[m], i));
+            g << "hres[" << i1++ << "]=" << (h==held.end() ? "0" : h->second) << ";\n";
+          }
+        }
+        g << "if (" << g(f, "arg1", "hres", "iw", "w") << ") return 1;\n";
+      } else {
+        // Results already evaluated
+        for (casadi_int i=0; i<res.size(); ++i) {
+          auto h = held.find(std::make_pair(&e-algorithm_.data(), i));
+          if (h==held.end()) continue;
+          casadi_int n = e.data->sparsity(i).nnz();
+          g << g.copy(h->second, n, g.work(res[i], n)) << "\n";
+        }
+      }
     }
   }
 
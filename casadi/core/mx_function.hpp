@@ -165,6 +165,17 @@ namespace casadi {
         \identifier{2d} */
     void codegen_body(CodeGenerator& g) const override;
 
+    /** \brief Get required length of w field in generated code
+
+        Called functions needing more work in generated code shift the work vector elements */
+    size_t codegen_sz_w(const CodeGenerator& g) const override;
+
+    /** \brief Calls to SX functions with the same arguments, fused for code generation
+
+        Instruction indices of each group with the function evaluating all their outputs */
+    std::vector<std::pair<std::vector<casadi_int>, Function> >
+      codegen_fused(CodeGenerator& g) const;
+
     /** \brief Serialize an object without type information
 
         \identifier{2e} */
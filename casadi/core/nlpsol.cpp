@@ -283,6 +283,7 @@ namespace casadi {
     no_nlp_grad_ = false;
     error_on_fail_ = false;
     sens_linsol_ = "qr";
+    tangential_predictor_ = false;
   }
 
   Nlpsol::~Nlpsol() {
@@ -400,6 +401,11 @@ namespace casadi {
       {"sens_linsol_options",
        {OT_DICT,
         "Linear solver options used for parametric sensitivities."}},
+      {"tangential_predictor",
+       {OT_BOOL,
+        "Linearize and factorize the KKT system after each successful solve, "
+        "so that nlpsol_predictor can update the solution for new parameters "
+        "with a single back-solve (default false). Uses 'sens_linsol'."}},
       {"detect_simple_bounds",
        {OT_BOOL,
         "Automatically detect simple bounds (lbx/ubx) (default false). "
@@ -407,6 +413,16 @@ namespace casadi {
         "1) Subtleties in heuristics and stopping criteria may change the solution, "
         "2) IPOPT may lie about multipliers of simple equality bounds unless "
         "'fixed_variable_treatment' is set to 'relax_bounds'."}},
+      {"parallel_blocks",
+       {OT_INT,
+        "Hint that the derivative functions are block-separable: split each of them "
+        "into this many blocks of output nonzeros and evaluate the blocks on separate "
+        "threads (default 1, no splitting). Requires SX functions, cf. 'expand'. "
+        "Not to be combined with solvers that evaluate the oracle from multiple threads."}},
+      {"parallel_functions",
+       {OT_STRINGVECTOR,
+        "Functions affected by 'parallel_blocks' "
+        "(default: nlp_jac_g, nlp_jac_fg, nlp_hess_l)."}},
       {"detect_simple_bounds_is_simple",
        {OT_BOOLVECTOR,
         "For internal use only."}},
@@ -477,9 +493,21 @@ namespace casadi {
         sens_linsol_ = op.second.to_string();
       } else if (op.first=="sens_linsol_options") {
         sens_linsol_options_ = op.second;
+      } else if (op.first=="tangential_predictor") {
+        tangential_predictor_ = op.second;
+      } else if (op.first=="parallel_blocks") {
+        parallel_blocks_ = op.second;
+      } else if (op.first=="parallel_functions") {
+        parallel_functions_ = op.second;
       }
     }
 
+    // Default functions split for parallel evaluation
+    casadi_assert(parallel_blocks_ >= 1, "Option 'parallel_blocks' must be positive");
+    if (parallel_blocks_ > 1 && parallel_functions_.empty()) {
+      parallel_functions_ = {"nlp_jac_g", "nlp_jac_fg", "nlp_hess_l"};
+    }
+
     // Deprecated option
     if (calc_multipliers_) {
       calc_lam_x_ = true;
@@ -573,6 +601,16 @@ namespace casadi {
                       {"f", "g", "grad:gamma:x", "grad:gamma:p"},
                       {{"gamma", {"f", "g"}}});
     }
+
+    // Derivatives needed for the tangential predictor
+    if (tangential_predictor_) {
+      casadi_assert(detect_simple_bounds_is_simple_.empty(),
+        "Simple bound detection not compatible with tangential_predictor");
+      create_function("nlp_pred", {"x", "p", "lam:f", "lam:g"},
+                      {"jac:g:x", "hess:gamma:x:x", "jac:g:p", "hess:gamma:x:p"},
+                      {{"gamma", {"f", "g"}}});
+      set_predictor();
+    }
   }
 
   int detect_bounds_callback(const double** arg, double** res,
@@ -608,9 +646,29 @@ namespace casadi {
     m->add_stat("callback_fun");
     m->success = false;
     m->unified_return_status = SOLVER_RET_UNKNOWN;
+    m->pred_valid = false;
+    if (tangential_predictor_) {
+      const Function& nlp_pred = get_function("nlp_pred");
+      m->pred_z.resize(nx_);
+      m->pred_lam.resize(nx_ + ng_);
+      m->pred_p.resize(np_);
+      m->pred_lbz.resize(nx_ + ng_);
+      m->pred_ubz.resize(nx_ + ng_);
+      m->pred_jac_g.resize(nlp_pred.nnz_out(0));
+      m->pred_hess_l.resize(nlp_pred.nnz_out(1));
+      m->pred_jac_gp.resize(nlp_pred.nnz_out(2));
+      m->pred_hess_lp.resize(nlp_pred.nnz_out(3));
+      m->pred_kkt.resize(pred_kkt_sp_.nnz());
+      m->pred_linsol = pred_linsol_;
+      m->pred_linsol_mem = pred_linsol_.checkout();
+    }
     return 0;
   }
 
+  NlpsolMemory::~NlpsolMemory() {
+    if (!pred_linsol.is_null()) pred_linsol.release(pred_linsol_mem);
+  }
+
   void Nlpsol::check_inputs(void* mem) const {
     auto m = static_cast<NlpsolMemory*>(mem);
     auto d_nlp = &m->d_nlp;
@@ -763,6 +821,18 @@ namespace casadi {
       bound_consistency(nx_+ng_, d_nlp->z, d_nlp->lam, d_nlp->lbz, d_nlp->ubz);
     }
 
+    // Keep the KKT factorization for the tangential predictor
+    if (tangential_predictor_) {
+      m->pred_valid = false;
+      if (!flag && m->success) {
+        if (pred_factorize(m)) {
+          casadi_warning("Failed to factorize the KKT matrix for the tangential predictor");
+        } else {
+          m->pred_valid = true;
+        }
+      }
+    }
+
     // Get optimal solution
     casadi_copy(d_nlp->z, nx_, d_nlp->x);
 
@@ -854,6 +924,212 @@ namespace casadi {
     return ret;
   }
 
+  void Nlpsol::set_predictor() {
+    const Function& nlp_pred = get_function("nlp_pred");
+    const Sparsity& sp_jg = nlp_pred.sparsity_out(0);
+    const Sparsity& sp_hl = nlp_pred.sparsity_out(1);
+
+    // KKT matrix for any active set, cf. get_forward
+    pred_kkt_sp_ = Sparsity::blockcat({{sp_hl.unite(Sparsity::diag(nx_)), sp_jg.T()},
+                                       {sp_jg, Sparsity::diag(ng_)}});
+
+    // Where to take each nonzero from
+    const casadi_int* colind = pred_kkt_sp_.colind();
+    const casadi_int* row = pred_kkt_sp_.row();
+    pred_kkt_hl_.assign(pred_kkt_sp_.nnz(), -1);
+    pred_kkt_jg_.assign(pred_kkt_sp_.nnz(), -1);
+    for (casadi_int c=0; c<nx_+ng_; ++c) {
+      for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+        casadi_int r = row[k];
+        if (r<nx_ && c<nx_) {
+          pred_kkt_hl_[k] = sp_hl.get_nz(r, c);
+        } else if (r<nx_) {
+          pred_kkt_jg_[k] = sp_jg.get_nz(c-nx_, r);
+        } else if (c<nx_) {
+          pred_kkt_jg_[k] = sp_jg.get_nz(r-nx_, c);
+        }
+      }
+    }
+
+    // Linear solver
+    pred_linsol_ = Linsol(name_ + "_pred_linsol", sens_linsol_, pred_kkt_sp_,
+                          sens_linsol_options_);
+  }
+
+  int Nlpsol::pred_factorize(NlpsolMemory* m) const {
+    auto d_nlp = &m->d_nlp;
+
+    // Linearization point
+    casadi_copy(d_nlp->z, nx_, get_ptr(m->pred_z));
+    casadi_copy(d_nlp->lam, nx_+ng_, get_ptr(m->pred_lam));
+    casadi_copy(d_nlp->p, np_, get_ptr(m->pred_p));
+    casadi_copy(d_nlp->lbz, nx_+ng_, get_ptr(m->pred_lbz));
+    casadi_copy(d_nlp->ubz, nx_+ng_, get_ptr(m->pred_ubz));
+
+    // Constraint Jacobian and Hessian of the Lagrangian w.r.t. x and p
+    const double lam_f = 1.;
+    m->arg[0] = d_nlp->z;
+    m->arg[1] = d_nlp->p;
+    m->arg[2] = &lam_f;
+    m->arg[3] = d_nlp->lam + nx_;
+    m->res[0] = get_ptr(m->pred_jac_g);
+    m->res[1] = get_ptr(m->pred_hess_l);
+    m->res[2] = get_ptr(m->pred_jac_gp);
+    m->res[3] = get_ptr(m->pred_hess_lp);
+    if (calc_function(m, "nlp_pred")) return 1;
+
+    // Assemble the KKT matrix for the active set given by the multiplier signs
+    const casadi_int* colind = pred_kkt_sp_.colind();
+    const casadi_int* row = pred_kkt_sp_.row();
+    for (casadi_int c=0; c<nx_+ng_; ++c) {
+      for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+        casadi_int r = row[k];
+        bool active = std::fabs(m->pred_lam[r]) > min_lam_;
+        double v = 0;
+        if (r<nx_) {
+          if (active) {
+            v = r==c ? 1 : 0;
+          } else if (pred_kkt_hl_[k]>=0) {
+            v = m->pred_hess_l[pred_kkt_hl_[k]];
+          } else if (pred_kkt_jg_[k]>=0) {
+            v = m->pred_jac_g[pred_kkt_jg_[k]];
+          }
+        } else {
+          if (!active) {
+            v = r==c ? -1 : 0;
+          } else if (pred_kkt_jg_[k]>=0) {
+            v = m->pred_jac_g[pred_kkt_jg_[k]];
+          }
+        }
+        m->pred_kkt[k] = v;
+      }
+    }
+
+    // Factorize
+    return pred_linsol_.nfact(get_ptr(m->pred_kkt), m->pred_linsol_mem);
+  }
+
+  int Nlpsol::predict(const double** arg, double** res, double* w) const {
+    casadi_assert(tangential_predictor_,
+      "Tangential predictor requires the option 'tangential_predictor'");
+    auto m = static_cast<NlpsolMemory*>(memory(0));
+    casadi_assert(m->pred_valid,
+      "No KKT factorization available. The solver must first be called successfully.");
+    const Function& nlp_pred = get_function("nlp_pred");
+    const Sparsity& sp_jg = nlp_pred.sparsity_out(0);
+    const Sparsity& sp_hl = nlp_pred.sparsity_out(1);
+    const Sparsity& sp_jgp = nlp_pred.sparsity_out(2);
+    const Sparsity& sp_hlp = nlp_pred.sparsity_out(3);
+
+    // Work vectors
+    double* dp = w; w += np_;
+    double* v = w; w += nx_ + ng_;
+    double* t = w; w += nx_;
+
+    // Parameter step
+    casadi_copy(arg[0], np_, dp);
+    casadi_axpy(np_, -1., get_ptr(m->pred_p), dp);
+
+    // Change of a bound, with missing inputs taking their default values
+    auto bound_step = [&](casadi_int i, bool upper) {
+      const double* b = i<nx_ ? arg[upper ? 2 : 1] : arg[upper ? 4 : 3];
+      casadi_int j = i<nx_ ? i : i-nx_;
+      double b_new = b ? b[j] : (upper ? inf : -inf);
+      double db = b_new - (upper ? m->pred_ubz[i] : m->pred_lbz[i]);
+      return std::isfinite(db) ? db : 0.;
+    };
+
+    // Right-hand side, cf. get_forward
+    casadi_clear(v, nx_+ng_);
+    casadi_mv(get_ptr(m->pred_hess_lp), sp_hlp, dp, v, 0);
+    casadi_mv(get_ptr(m->pred_jac_gp), sp_jgp, dp, v + nx_, 0);
+    for (casadi_int i=0; i<nx_+ng_; ++i) {
+      double lam = m->pred_lam[i];
+      if (lam > min_lam_) {
+        v[i] = bound_step(i, true) - (i<nx_ ? 0 : v[i]);
+      } else if (lam < -min_lam_) {
+        v[i] = bound_step(i, false) - (i<nx_ ? 0 : v[i]);
+      } else {
+        v[i] = i<nx_ ? -v[i] : 0;
+      }
+    }
+
+    // Back-solve with the stored factorization
+    if (pred_linsol_.solve(get_ptr(m->pred_kkt), v, 1, false, m->pred_linsol_mem)) return 1;
+
+    // Primal step and constraint multipliers
+    if (res[0]) {
+      casadi_copy(get_ptr(m->pred_z), nx_, res[0]);
+      casadi_axpy(nx_, 1., v, res[0]);
+    }
+    if (res[2]) {
+      casadi_copy(get_ptr(m->pred_lam) + nx_, ng_, res[2]);
+      casadi_axpy(ng_, 1., v + nx_, res[2]);
+    }
+
+    // Bound multipliers from stationarity
+    if (res[1]) {
+      casadi_clear(t, nx_);
+      casadi_mv(get_ptr(m->pred_hess_l), sp_hl, v, t, 0);
+      casadi_mv(get_ptr(m->pred_hess_lp), sp_hlp, dp, t, 0);
+      casadi_mv(get_ptr(m->pred_jac_g), sp_jg, v + nx_, t, 1);
+      casadi_copy(get_ptr(m->pred_lam), nx_, res[1]);
+      casadi_axpy(nx_, -1., t, res[1]);
+    }
+    return 0;
+  }
+
+  Function nlpsol_predictor(const std::string& name, const Function& solver,
+                            const Dict& opts) {
+    casadi_assert(solver.is_a("Nlpsol", true), "Expected an NLP solver");
+    return Function::create(new NlpsolPredictor(name, solver), opts);
+  }
+
+  // Correspondence between predictor and NLP solver inputs and outputs
+  static const NlpsolInput pred_in[] = {NLPSOL_P, NLPSOL_LBX, NLPSOL_UBX, NLPSOL_LBG, NLPSOL_UBG};
+  static const NlpsolOutput pred_out[] = {NLPSOL_X, NLPSOL_LAM_X, NLPSOL_LAM_G};
+
+  NlpsolPredictor::NlpsolPredictor(const std::string& name, const Function& solver)
+    : FunctionInternal(name), solver_(solver) {
+  }
+
+  NlpsolPredictor::~NlpsolPredictor() {
+    clear_mem();
+  }
+
+  Sparsity NlpsolPredictor::get_sparsity_in(casadi_int i) {
+    return solver_.sparsity_in(pred_in[i]);
+  }
+
+  Sparsity NlpsolPredictor::get_sparsity_out(casadi_int i) {
+    return solver_.sparsity_out(pred_out[i]);
+  }
+
+  std::string NlpsolPredictor::get_name_in(casadi_int i) {
+    return nlpsol_in(pred_in[i]);
+  }
+
+  std::string NlpsolPredictor::get_name_out(casadi_int i) {
+    return nlpsol_out(pred_out[i]);
+  }
+
+  double NlpsolPredictor::get_default_in(casadi_int ind) const {
+    return nlpsol_default_in(pred_in[ind]);
+  }
+
+  void NlpsolPredictor::init(const Dict& opts) {
+    // Call the initialization method of the base class
+    FunctionInternal::init(opts);
+
+    // Work vectors
+    alloc_w(solver_.get<Nlpsol>()->pred_sz_w());
+  }
+
+  int NlpsolPredictor::eval(const double** arg, double** res, casadi_int* iw, double* w,
+                            void* mem) const {
+    return solver_.get<Nlpsol>()->predict(arg, res, w);
+  }
+
 
   Function Nlpsol::
   get_forward(casadi_int nfwd, const std::string& name,
@@ -1229,6 +1505,11 @@ namespace casadi {
   }
 
   void Nlpsol::codegen_declarations(CodeGenerator& g) const {
+    for (auto&& e : all_functions_) {
+      casadi_assert(e.second.f.class_name()!="EdgePushing",
+        "Code generation of '" + e.first + "' not supported with hessian_method "
+        "'edge_pushing', use 'symbolic' instead.");
+    }
     g.add_auxiliary(CodeGenerator::AUX_FILL);
     if (calc_f_ || calc_g_ || calc_lam_x_ || calc_lam_p_)
       g.add_dependency(get_function("nlp_grad"));
@@ -1287,7 +1568,7 @@ namespace casadi {
   void Nlpsol::serialize_body(SerializingStream &s) const {
     OracleFunction::serialize_body(s);
 
-    s.version("Nlpsol", 4);
+    s.version("Nlpsol", 5);
     s.pack("Nlpsol::nx", nx_);
     s.pack("Nlpsol::ng", ng_);
     s.pack("Nlpsol::np", np_);
@@ -1312,6 +1593,7 @@ namespace casadi {
     s.pack("Nlpsol::detect_simple_bounds_is_simple", detect_simple_bounds_is_simple_);
     s.pack("Nlpsol::detect_simple_bounds_parts", detect_simple_bounds_parts_);
     s.pack("Nlpsol::detect_simple_bounds_target_x", detect_simple_bounds_target_x_);
+    s.pack("Nlpsol::tangential_predictor", tangential_predictor_);
   }
 
   void Nlpsol::serialize_type(SerializingStream &s) const {
@@ -1324,7 +1606,7 @@ namespace casadi {
   }
 
   Nlpsol::Nlpsol(DeserializingStream & s) : OracleFunction(s) {
-    int version = s.version("Nlpsol", 1, 4);
+    int version = s.version("Nlpsol", 1, 5);
     s.unpack("Nlpsol::nx", nx_);
     s.unpack("Nlpsol::ng", ng_);
     s.unpack("Nlpsol::np", np_);
@@ -1366,7 +1648,13 @@ namespace casadi {
         detect_simple_bounds_target_g_.push_back(i);
       }
     }
+    if (version>=5) {
+      s.unpack("Nlpsol::tangential_predictor", tangential_predictor_);
+    } else {
+      tangential_predictor_ = false;
+    }
     set_nlpsol_prob();
+    if (tangential_predictor_) set_predictor();
   }
 
 } // namespace casadi
@@ -83,6 +83,18 @@ namespace casadi {
                                 const Function& nlp, const Dict& opts=Dict());
   ///@}
 
+  /** \brief Tangential predictor for a parametric NLP
+
+      Returns a function (p, lbx, ubx, lbg, ubg) -> (x, lam_x, lam_g) which updates
+      the most recent solution of \a solver to first order, with a single back-solve
+      using the KKT factorization stored during that solve. The active set is assumed
+      unchanged. Requires the solver option 'tangential_predictor' and uses the
+      solver's default memory object, i.e. the solver should not be evaluated
+      concurrently.
+  */
+  CASADI_EXPORT Function nlpsol_predictor(const std::string& name, const Function& solver,
+                                          const Dict& opts=Dict());
+
   /** \brief Get input scheme of NLP solvers
 
   * \if EXPANDED
@@ -29,6 +29,7 @@
 #include "nlpsol.hpp"
 #include "oracle_function.hpp"
 #include "plugin_interface.hpp"
+#include "linsol.hpp"
 
 
 /// \cond INTERNAL
@@ -46,6 +47,16 @@ namespace casadi {
     bool success;
     // Return status
     UnifiedReturnStatus unified_return_status;
+    // Tangential predictor: is a factorization available?
+    bool pred_valid;
+    // Linearization point: primal-dual solution, parameters and bounds
+    std::vector<double> pred_z, pred_lam, pred_p, pred_lbz, pred_ubz;
+    // Derivatives at the linearization point and KKT matrix nonzeros
+    std::vector<double> pred_jac_g, pred_hess_l, pred_jac_gp, pred_hess_lp, pred_kkt;
+    // KKT linear solver and its memory object, released with the memory block
+    Linsol pred_linsol;
+    int pred_linsol_mem;
+    ~NlpsolMemory();
   };
 
   /** \brief NLP solver storage class
@@ -108,6 +119,18 @@ namespace casadi {
     /// Cache for KKT function
     mutable WeakRef kkt_;
 
+    /// Keep a factorized KKT matrix for the tangential predictor
+    bool tangential_predictor_;
+
+    /// Sparsity of the (active-set) KKT matrix
+    Sparsity pred_kkt_sp_;
+
+    /// For each KKT nonzero, the Hessian or Jacobian nonzero it is taken from (or -1)
+    std::vector<casadi_int> pred_kkt_hl_, pred_kkt_jg_;
+
+    /// Linear solver for the KKT matrix
+    Linsol pred_linsol_;
+
     /** \brief Serialize an object without type information
 
         \identifier{1nl} */
@@ -264,6 +287,22 @@ namespace casadi {
     // Get KKT function
     Function kkt() const;
 
+    /// Set up the KKT sparsity pattern and linear solver for the tangential predictor
+    void set_predictor();
+
+    /// Linearize and factorize the KKT system at the current solution
+    int pred_factorize(NlpsolMemory* m) const;
+
+    /// Work vector size of the tangential predictor
+    casadi_int pred_sz_w() const { return np_ + 2*nx_ + ng_;}
+
+    /** \brief Tangential predictor
+
+        First-order update of the last solution for new parameters and bounds,
+        reusing the KKT factorization stored in the default memory object.
+        Inputs: p, lbx, ubx, lbg, ubg. Outputs: x, lam_x, lam_g. */
+    int predict(const double** arg, double** res, double* w) const;
+
     // Make sure primal-dual solution is consistent with bounds
     static void bound_consistency(casadi_int n, double* z, double* lam,
                                   const double* lbz, const double* ubz);
@@ -320,6 +359,52 @@ namespace casadi {
     void set_nlpsol_prob();
   };
 
+  /** \brief Tangential predictor of an NLP solver
+
+      Evaluates Nlpsol::predict for the solver it wraps, cf. nlpsol_predictor. */
+  class CASADI_EXPORT NlpsolPredictor : public FunctionInternal {
+  public:
+    /// Constructor
+    NlpsolPredictor(const std::string& name, const Function& solver);
+
+    /// Destructor
+    ~NlpsolPredictor() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override {return "NlpsolPredictor";}
+
+    ///@{
+    /** \brief Number of function inputs and outputs */
+    size_t get_n_in() override { return 5;}
+    size_t get_n_out() override { return 3;}
+    ///@}
+
+    /// @{
+    /** \brief Sparsities of function inputs and outputs */
+    Sparsity get_sparsity_in(casadi_int i) override;
+    Sparsity get_sparsity_out(casadi_int i) override;
+    /// @}
+
+    ///@{
+    /** \brief Names of function input and outputs */
+    std::string get_name_in(casadi_int i) override;
+    std::string get_name_out(casadi_int i) override;
+    /// @}
+
+    /** \brief Get default input value */
+    double get_default_in(casadi_int ind) const override;
+
+    /// Initialize
+    void init(const Dict& opts) override;
+
+    // Evaluate numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w,
+             void* mem) const override;
+
+    /// The NLP solver
+    Function solver_;
+  };
+
 } // namespace casadi
 /// \endcond
 #endif // CASADI_NLPSOL_IMPL_HPP
@@ -24,12 +24,21 @@
 
 
 #include "oracle_function.hpp"
+#include "edge_pushing.hpp"
 #include "external.hpp"
 #include "serializing_stream.hpp"
 
 #include <iomanip>
 #include <iostream>
 
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.thread.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <thread>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
 namespace casadi {
 
 OracleCallback::OracleCallback(const std::string& name,
@@ -42,6 +51,7 @@ OracleCallback::OracleCallback() : name("undefined"), oracle_(0) {
 
 OracleFunction::OracleFunction(const std::string& name, const Function& oracle)
 : FunctionInternal(name), oracle_(oracle) {
+  parallel_blocks_ = 1;
 }
 
 OracleFunction::~OracleFunction() {
@@ -64,7 +74,13 @@ const Options OracleFunction::options_
     {"specific_options",
       {OT_DICT,
       "Options for specific auto-generated functions,"
-      " overwriting the defaults from common_options. Nested dictionary."}}
+      " overwriting the defaults from common_options. Nested dictionary."}},
+    {"hessian_method",
+      {OT_STRING,
+      "Method for Hessians of the oracle: 'symbolic' [default] differentiates the symbolic "
+      "gradient, 'edge_pushing' evaluates sparse second order adjoints numerically in a single "
+      "reverse sweep over the SX algorithm (requires an SX oracle, e.g. with 'expand'). "
+      "'edge_pushing' is not supported in code generation."}}
   }
 };
 
@@ -79,6 +95,8 @@ void OracleFunction::init(const Dict& opts) {
 
   max_num_threads_ = 1;
 
+  hessian_method_ = "symbolic";
+
   // Read options
   for (auto&& op : opts) {
     if (op.first=="expand") {
@@ -97,12 +115,17 @@ void OracleFunction::init(const Dict& opts) {
       monitor_ = op.second;
     } else if (op.first=="show_eval_warnings") {
       show_eval_warnings_ = op.second;
+    } else if (op.first=="hessian_method") {
+      hessian_method_ = op.second.to_string();
     }
   }
 
   // Replace MX oracle with SX oracle?
   if (expand) oracle_ = oracle_.expand();
 
+  casadi_assert(hessian_method_=="symbolic" || hessian_method_=="edge_pushing",
+    "Unknown hessian_method '" + hessian_method_ + "'");
+
   stride_arg_ = 0;
   stride_res_ = 0;
   stride_iw_ = 0;
@@ -112,19 +135,31 @@ void OracleFunction::init(const Dict& opts) {
 
 void OracleFunction::finalize() {
 
+  // Split functions for parallel evaluation
+  if (parallel_blocks_ > 1) {
+    for (const std::string& fname : parallel_functions_) {
+      if (has_function(fname)) split_function(fname, parallel_blocks_);
+    }
+    max_num_threads_ = std::max(max_num_threads_, static_cast<int>(parallel_blocks_));
+  }
+
   // Allocate space for (parallel) evaluations
   // Lifted from set_function as max_num_threads_ is not known yet in that method
   for (auto&& e : all_functions_) {
-    Function& fcn = e.second.f;
-    // Compute strides for multi threading
-    size_t sz_arg, sz_res, sz_iw, sz_w;
-    fcn.sz_work(sz_arg, sz_res, sz_iw, sz_w);
-    stride_arg_ = std::max(stride_arg_, sz_arg);
-    stride_res_ = std::max(stride_res_, sz_res);
-    stride_iw_ = std::max(stride_iw_, sz_iw);
-    stride_w_ = std::max(stride_w_, sz_w);
-    bool persistent = false;
-    alloc(fcn, persistent, max_num_threads_);
+    // Function and the blocks it is split into, if any
+    std::vector<Function> fcns = e.second.blocks;
+    fcns.push_back(e.second.f);
+    for (const Function& fcn : fcns) {
+      // Compute strides for multi threading
+      size_t sz_arg, sz_res, sz_iw, sz_w;
+      fcn.sz_work(sz_arg, sz_res, sz_iw, sz_w);
+      stride_arg_ = std::max(stride_arg_, sz_arg);
+      stride_res_ = std::max(stride_res_, sz_res);
+      stride_iw_ = std::max(stride_iw_, sz_iw);
+      stride_w_ = std::max(stride_w_, sz_w);
+      bool persistent = false;
+      alloc(fcn, persistent, max_num_threads_);
+    }
   }
 
   // Set corresponding monitors
@@ -234,29 +269,78 @@ Function OracleFunction::create_function(const Function& oracle, const std::stri
     casadi_assert(ret.n_in() == s_in.size(), fname + " has wrong number of inputs");
     casadi_assert(ret.n_out() == s_out.size(), fname + " has wrong number of outputs");
   } else {
-    // Retrieve specific set of options if available
-    Dict specific_options;
-    auto it = specific_options_.find(fname);
-    if (it!=specific_options_.end()) specific_options = it->second;
+    // Hessian evaluated on the SX algorithm
+    if (hessian_method_=="edge_pushing" && s_out.size()==1) {
+      ret = create_edge_pushing(oracle, fname, s_in, s_out[0], aux, opts);
+    }
 
-    // Combine specific and common options
-    Dict opt = combine(specific_options, common_options_);
-    opt = combine(opts, opt);
+    if (ret.is_null()) {
+      // Retrieve specific set of options if available
+      Dict specific_options;
+      auto it = specific_options_.find(fname);
+      if (it!=specific_options_.end()) specific_options = it->second;
 
-    // Generate the function
-    ret = oracle.factory(fname, s_in, s_out, aux, opt);
+      // Combine specific and common options
+      Dict opt = combine(specific_options, common_options_);
+      opt = combine(opts, opt);
 
-    // Make sure that it's sound
-    if (ret.has_free()) {
-      casadi_error("Cannot create '" + fname + "' since " + str(ret.get_free()) + " are free.");
+      // Generate the function
+      ret = oracle.factory(fname, s_in, s_out, aux, opt);
+
+      // Make sure that it's sound
+      if (ret.has_free()) {
+        casadi_error("Cannot create '" + fname + "' since " + str(ret.get_free()) + " are free.");
+      }
     }
 
     // Add to cache
     tocache(ret);
   }
 
-  // Save and return
-  set_function(ret, fname, true);
+  // Save and return, edge pushing cannot be just-in-time compiled
+  set_function(ret, fname, ret.class_name()!="EdgePushing");
+  return ret;
+}
+
+Function OracleFunction::create_edge_pushing(const Function& oracle, const std::string& fname,
+    const std::vector<std::string>& s_in,
+    const std::string& s_out,
+    const Function::AuxOut& aux,
+    const Dict& opts) {
+  // Only a diagonal Hessian block, optionally one triangle: [triu:|tril:]hess:f:x:x
+  std::string triangle = "full", s = s_out;
+  if (s.compare(0, 5, "triu:")==0 || s.compare(0, 5, "tril:")==0) {
+    triangle = s.substr(0, 4);
+    s = s.substr(5);
+  }
+  std::vector<std::string> parts;
+  std::stringstream ss(s);
+  std::string part;
+  while (std::getline(ss, part, ':')) parts.push_back(part);
+  if (parts.size()!=4 || parts[0]!="hess" || parts[2]!=parts[3]) return Function();
+  auto it_x = std::find(s_in.begin(), s_in.end(), parts[2]);
+  if (it_x==s_in.end()) return Function();
+  if (!oracle.is_a("SXFunction")) {
+    casadi_warning("hessian_method 'edge_pushing' requires an SX oracle, "
+      "falling back to symbolic Hessian for '" + fname + "'. Consider the 'expand' option.");
+    return Function();
+  }
+
+  // Retrieve specific set of options if available
+  Dict specific_options;
+  auto it = specific_options_.find(fname);
+  if (it!=specific_options_.end()) specific_options = it->second;
+  Dict opt = combine(specific_options, common_options_);
+  opt = combine(opts, opt);
+
+  // Scalar expression to be differentiated, as a function of the same inputs
+  Function f = oracle.factory(fname + "_" + parts[1], s_in, {parts[1]}, aux, opt);
+
+  // Hessian by edge pushing, output named as by the factory
+  std::string oname = s_out;
+  std::replace(oname.begin(), oname.end(), ':', '_');
+  Function ret = Function::create(
+    new EdgePushing(fname, f, it_x - s_in.begin(), 0, triangle, oname), Dict());
   return ret;
 }
 
@@ -276,6 +360,108 @@ set_function(const Function& fcn, const std::string& fname, bool jit) {
   r.jit = jit;
 }
 
+void OracleFunction::split_function(const std::string& fname, casadi_int n_blocks) {
+  RegFun& r = all_functions_.at(fname);
+  // Only SX functions can be split without duplicating work
+  if (!r.f.is_a("SXFunction")) {
+    casadi_warning("Cannot split '" + fname + "' for parallel evaluation: "
+      "not an SX function, consider the 'expand' option.");
+    return;
+  }
+  if (jit_) {
+    casadi_warning("Cannot split '" + fname + "' for parallel evaluation when jit is enabled.");
+    return;
+  }
+  // Symbolic inputs and outputs
+  std::vector<SX> arg = r.f.sx_in();
+  std::vector<SX> res = r.f(arg);
+  // Total number of output nonzeros
+  casadi_int nnz = 0;
+  for (const SX& e : res) nnz += e.nnz();
+  if (nnz < n_blocks) return;
+  // Assign a contiguous range of the concatenated output nonzeros to each block
+  r.blocks.clear();
+  for (casadi_int k = 0; k < n_blocks; ++k) {
+    casadi_int lo = (k * nnz) / n_blocks, hi = ((k + 1) * nnz) / n_blocks;
+    std::vector<SX> res_k;
+    casadi_int offset = 0;
+    for (const SX& e : res) {
+      const std::vector<SXElem>& nz = e.nonzeros();
+      casadi_int begin = std::min(std::max(lo - offset, casadi_int(0)), e.nnz());
+      casadi_int end = std::min(std::max(hi - offset, casadi_int(0)), e.nnz());
+      res_k.push_back(SX(std::vector<SXElem>(nz.begin() + begin, nz.begin() + end)));
+      offset += e.nnz();
+    }
+    r.blocks.push_back(Function(fname + "_block" + str(k), arg, res_k,
+      r.f.name_in(), r.f.name_out()));
+  }
+  if (verbose_) {
+    casadi_message(name_ + "::split_function " + fname + " into " + str(n_blocks) + " blocks");
+  }
+}
+
+/// Evaluate one block, catching exceptions
+static void eval_block(const Function& f, const double** arg, double** res,
+    casadi_int* iw, double* w, int& ret) {
+  try {
+    ret = f(arg, res, iw, w);
+  } catch (std::exception& e) {
+    ret = 1;
+    casadi_warning("Exception raised: " + std::string(e.what()));
+  } catch (...) {
+    ret = 1;
+    casadi_warning("Uncaught exception.");
+  }
+}
+
+int OracleFunction::eval_blocks(OracleMemory* m, const std::vector<Function>& blocks,
+    const double** arg, double** res) const {
+  // Copy input and output pointers, the work vectors of thread 0 are reused
+  casadi_int n_in = blocks.front().n_in(), n_out = blocks.front().n_out();
+  std::vector<const double*> arg0(arg, arg + n_in);
+  std::vector<double*> res0(res, res + n_out);
+  // Offset of each block in the outputs
+  std::vector<casadi_int> offset(n_out, 0);
+  // Set up thread-local work vectors
+  for (size_t k = 0; k < blocks.size(); ++k) {
+    LocalOracleMemory* ml = m->thread_local_mem.at(k);
+    for (casadi_int i = 0; i < n_in; ++i) ml->arg[i] = arg0[i];
+    for (casadi_int i = 0; i < n_out; ++i) {
+      ml->res[i] = res0[i] ? res0[i] + offset[i] : nullptr;
+      offset[i] += blocks[k].nnz_out(i);
+    }
+  }
+  // Return values
+  std::vector<int> ret_values(blocks.size(), 0);
+#ifdef CASADI_WITH_THREAD
+  // Spawn threads
+  std::vector<std::thread> threads;
+  for (size_t k = 0; k < blocks.size(); ++k) {
+    LocalOracleMemory* ml = m->thread_local_mem.at(k);
+    threads.emplace_back(
+      [](const Function& f, const double** arg, double** res,
+          casadi_int* iw, double* w, int& ret) {
+            eval_block(f, arg, res, iw, w, ret);
+          },
+      std::ref(blocks[k]), ml->arg, ml->res, ml->iw, ml->w, std::ref(ret_values[k]));
+  }
+  // Join threads
+  for (auto&& th : threads) th.join();
+#else // CASADI_WITH_THREAD
+  // Serial evaluation
+  for (size_t k = 0; k < blocks.size(); ++k) {
+    LocalOracleMemory* ml = m->thread_local_mem.at(k);
+    eval_block(blocks[k], ml->arg, ml->res, ml->iw, ml->w, ret_values[k]);
+  }
+#endif // CASADI_WITH_THREAD
+  // Restore input and output pointers
+  std::copy(arg0.begin(), arg0.end(), arg);
+  std::copy(res0.begin(), res0.end(), res);
+  // Aggregate return value
+  for (int e : ret_values) if (e) return e;
+  return 0;
+}
+
 
   void OracleFunction::codegen_body_enter(CodeGenerator& g) const {
     g.local("d_oracle", "struct casadi_oracle_data");
@@ -340,9 +526,18 @@ calc_function(OracleMemory* m, const std::string& fcn,
     casadi_message(s.str());
   }
 
+  // Nonzero blocks for parallel evaluation, if any
+  const std::vector<Function>& blocks = all_functions_.find(fcn)->second.blocks;
+
   // Evaluate memory-less
   try {
-    if (f(ml->arg, ml->res, ml->iw, ml->w)) {
+    if (!blocks.empty() && thread_id == 0) {
+      if (eval_blocks(m, blocks, ml->arg, ml->res)) {
+        // Recoverable error
+        if (monitored) casadi_message(name_ + ":" + fcn + " failed");
+        return 1;
+      }
+    } else if (f(ml->arg, ml->res, ml->iw, ml->w)) {
       // Recoverable error
       if (monitored) casadi_message(name_ + ":" + fcn + " failed");
       return 1;
@@ -410,13 +605,17 @@ int OracleFunction::calc_sp_reverse(const std::string& fcn, bvec_t** arg, bvec_t
   return get_function(fcn).rev(arg, res, iw, w);
 }
 
+void OracleFunction::add_dependencies(CodeGenerator& g) const {
+  g.add(oracle_);
+  for (auto&& e : all_functions_) {
+    if (e.second.jit) g.add(e.second.f);
+  }
+}
+
 std::string OracleFunction::generate_dependencies(const std::string& fname,
     const Dict& opts) const {
   CodeGenerator gen(fname, opts);
-  gen.add(oracle_);
-  for (auto&& e : all_functions_) {
-    if (e.second.jit) gen.add(e.second.f);
-  }
+  add_dependencies(gen);
   return gen.generate();
 }
 
@@ -424,8 +623,9 @@ void OracleFunction::jit_dependencies(const std::string& fname) {
   if (compiler_.is_null()) {
     if (verbose_) casadi_message("compiling to "+ fname+"'.");
     // JIT dependent functions
-    compiler_ = Importer(generate_dependencies(fname, Dict()),
-                        compiler_plugin_, jit_options_);
+    CodeGenerator gen(fname, jit_codegen_options());
+    add_dependencies(gen);
+    compiler_ = jit_compile(gen, "");
   }
   // Replace the Oracle functions with generated functions
   for (auto&& e : all_functions_) {
@@ -546,12 +746,13 @@ bool OracleFunction::has_function(const std::string& fname) const {
 void OracleFunction::serialize_body(SerializingStream &s) const {
   FunctionInternal::serialize_body(s);
 
-  s.version("OracleFunction", 3);
+  s.version("OracleFunction", 5);
   s.pack("OracleFunction::oracle", oracle_);
   s.pack("OracleFunction::common_options", common_options_);
   s.pack("OracleFunction::specific_options", specific_options_);
   s.pack("OracleFunction::show_eval_warnings", show_eval_warnings_);
   s.pack("OracleFunction::max_num_threads", max_num_threads_);
+  s.pack("OracleFunction::hessian_method", hessian_method_);
   s.pack("OracleFunction::all_functions::size", all_functions_.size());
   for (auto &e : all_functions_) {
     s.pack("OracleFunction::all_functions::key", e.first);
@@ -570,6 +771,7 @@ void OracleFunction::serialize_body(SerializingStream &s) const {
       s.pack("OracleFunction::all_functions::value::f", e.second.f);
     }
     s.pack("OracleFunction::all_functions::value::monitored", e.second.monitored);
+    s.pack("OracleFunction::all_functions::value::blocks", e.second.blocks);
   }
   s.pack("OracleFunction::monitor", monitor_);
   s.pack("OracleFunction::stride_arg", stride_arg_);
@@ -580,8 +782,9 @@ void OracleFunction::serialize_body(SerializingStream &s) const {
 }
 
 OracleFunction::OracleFunction(DeserializingStream& s) : FunctionInternal(s) {
+  parallel_blocks_ = 1;
 
-  int version = s.version("OracleFunction", 1, 3);
+  int version = s.version("OracleFunction", 1, 5);
   s.unpack("OracleFunction::oracle", oracle_);
   s.unpack("OracleFunction::common_options", common_options_);
   s.unpack("OracleFunction::specific_options", specific_options_);
@@ -593,6 +796,12 @@ OracleFunction::OracleFunction(DeserializingStream& s) : FunctionInternal(s) {
     max_num_threads_ = 1;
   }
 
+  if (version>=5) {
+    s.unpack("OracleFunction::hessian_method", hessian_method_);
+  } else {
+    hessian_method_ = "symbolic";
+  }
+
   size_t size;
 
   s.unpack("OracleFunction::all_functions::size", size);
@@ -619,6 +828,7 @@ OracleFunction::OracleFunction(DeserializingStream& s) : FunctionInternal(s) {
       }
     }
     s.unpack("OracleFunction::all_functions::value::monitored", r.monitored);
+    if (version>=4) s.unpack("OracleFunction::all_functions::value::blocks", r.blocks);
     all_functions_[key] = r;
   }
   s.unpack("OracleFunction::monitor", monitor_);
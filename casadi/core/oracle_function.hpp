@@ -92,12 +92,16 @@ namespace casadi {
     // Maximum number of threads
     int max_num_threads_;
 
+    // Method for Hessians of the oracle: "symbolic" or "edge_pushing"
+    std::string hessian_method_;
+
     // Information about one function
     struct RegFun {
       Function f;
       bool jit;
       Function f_original; // Relevant for jit
       bool monitored = false;
+      std::vector<Function> blocks; // Nonzero blocks for parallel evaluation
     };
 
     // All NLP functions
@@ -109,6 +113,10 @@ namespace casadi {
     // Memory stride in case of multipel threads
     size_t stride_arg_, stride_res_, stride_iw_, stride_w_;
 
+    // Split functions into nonzero blocks, evaluated on separate threads
+    casadi_int parallel_blocks_;
+    std::vector<std::string> parallel_functions_;
+
   public:
     /** \brief  Constructor
 
@@ -154,6 +162,13 @@ namespace casadi {
       const Function::AuxOut& aux=Function::AuxOut(),
       const Dict& opts=Dict());
 
+    /** Create a single Hessian block by edge pushing, null if not applicable */
+    Function create_edge_pushing(const Function& oracle, const std::string& fname,
+      const std::vector<std::string>& s_in,
+      const std::string& s_out,
+      const Function::AuxOut& aux,
+      const Dict& opts);
+
     /** Create an oracle function */
     Function create_function(const std::string& fname,
       const std::vector<std::string>& s_in,
@@ -178,6 +193,13 @@ namespace casadi {
     /** Register the function for evaluation and statistics gathering */
     void set_function(const Function& fcn) { set_function(fcn, fcn.name()); }
 
+    /** Split a registered function into blocks of output nonzeros */
+    void split_function(const std::string& fname, casadi_int n_blocks);
+
+    // Evaluate the nonzero blocks of a function in parallel
+    int eval_blocks(OracleMemory* m, const std::vector<Function>& blocks,
+      const double** arg, double** res) const;
+
     // Calculate an oracle function
     int calc_function(OracleMemory* m, const std::string& fcn,
       const double* const* arg=nullptr, int thread_id=0) const;
@@ -206,6 +228,9 @@ namespace casadi {
     // Check if a particular dependency exists
     bool has_function(const std::string& fname) const override;
 
+    /** \brief Add the oracle and the functions to be jit compiled */
+    void add_dependencies(CodeGenerator& g) const;
+
     /** \brief Export / Generate C code for the generated functions
 
         \identifier{j} */
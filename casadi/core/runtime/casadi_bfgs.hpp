@@ -47,3 +47,68 @@ void casadi_bfgs_reset(const casadi_int* sp_h, T1* h) {
     }
   }
 }
+
+// SYMBOL "bfgs_block"
+// Partitioned BFGS update: independent damped updates for each diagonal block
+// of a block-diagonal Hessian approximation, blk[i] is the block of variable i
+template<typename T1>
+void casadi_bfgs_block(const casadi_int* sp_h, T1* h, const T1* dx,
+                       const T1* glag, const T1* glag_old,
+                       const casadi_int* blk, casadi_int nblk, T1* w) {
+  // Local variables
+  casadi_int nx, ncol, c, k, i, b;
+  const casadi_int *colind, *row;
+  T1 *yk, *qk, *dxyk, *dxqk, omega;
+  // Dimension
+  nx = sp_h[0];
+  ncol = sp_h[1];
+  colind = sp_h+2; row = sp_h+ncol+3;
+  // Work vectors
+  yk = w; w += nx;
+  qk = w; w += nx;
+  dxyk = w; w += nblk;
+  dxqk = w; w += nblk;
+  // yk = glag - glag_old
+  casadi_copy(glag, nx, yk);
+  casadi_axpy(nx, -1., glag_old, yk);
+  // qk = H*dx, no coupling between blocks
+  casadi_clear(qk, nx);
+  casadi_mv(h, sp_h, dx, qk, 0);
+  // Inner products for each block
+  casadi_clear(dxyk, nblk);
+  casadi_clear(dxqk, nblk);
+  for (i=0; i<nx; ++i) {
+    dxyk[blk[i]] += dx[i]*yk[i];
+    dxqk[blk[i]] += dx[i]*qk[i];
+  }
+  // Powell damping for each block: yk = omega * yk + (1 - omega) * qk
+  for (i=0; i<nx; ++i) {
+    b = blk[i];
+    if (dxqk[b] <= 0) continue;
+    if (dxyk[b] < 0.2 * dxqk[b]) {
+      omega = 0.8 * dxqk[b] / (dxqk[b] - dxyk[b]);
+      yk[i] = omega * yk[i] + (1 - omega) * qk[i];
+    }
+  }
+  // dxyk <- 1 / (dx'*yk), dxqk <- 1 / (dx'*H*dx), skip blocks without curvature information
+  for (b=0; b<nblk; ++b) {
+    if (dxqk[b] <= 0) {
+      dxyk[b] = dxqk[b] = 0;
+      continue;
+    }
+    if (dxyk[b] < 0.2 * dxqk[b]) {
+      omega = 0.8 * dxqk[b] / (dxqk[b] - dxyk[b]);
+      dxyk[b] = omega * dxyk[b] + (1 - omega) * dxqk[b];
+    }
+    dxyk[b] = 1. / dxyk[b];
+    dxqk[b] = 1. / dxqk[b];
+  }
+  // Update H, rank-2 update restricted to each block
+  for (c=0; c<ncol; ++c) {
+    b = blk[c];
+    for (k=colind[c]; k<colind[c+1]; ++k) {
+      i = row[k];
+      h[k] += dxyk[b] * yk[i] * yk[c] - dxqk[b] * qk[i] * qk[c];
+    }
+  }
+}
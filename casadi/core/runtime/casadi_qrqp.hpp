@@ -1084,8 +1084,8 @@ int casadi_qrqp_prepare(casadi_qrqp_data<T1>* d) {
   casadi_qrqp_flip(d);
   // Form and factorize the KKT system
   casadi_qrqp_factorize(d);
-  // Termination message
-  if (!d->sing && d->index == -1) {
+  // Termination message, a violated constraint already in the active set needs more steps
+  if (!d->sing && d->index == -1 && d->pr < p->constr_viol_tol) {
     d->status = QP_SUCCESS;
     d->msg = "Converged";
     d->msg_ind = -2;
@@ -865,14 +865,42 @@ namespace casadi {
                           g.work(res[0], this->nnz())) << '\n';
     }
 
-    // Condegen the indices
-    std::string ind = g.constant(this->nz_);
-
-    // Perform the operation inplace
     g.local("cii", "const casadi_int", "*");
     g.local("rr", "casadi_real", "*");
     g.local("ss", "casadi_real", "*");
-    g << "for (cii=" << ind << ", rr=" << g.work(res[0], this->nnz()) << ", "
+
+    // Indices relative to the smallest one, shared between tables differing by an offset
+    casadi_int offset = 0;
+    if (g.compress && !this->nz_.empty() && !has_negative(this->nz_)) {
+      offset = *std::min_element(this->nz_.begin(), this->nz_.end());
+    }
+    std::vector<casadi_int> nz = this->nz_;
+    for (casadi_int& e : nz) e -= offset;
+    std::string rr = g.work(res[0], this->nnz());
+    if (offset) rr += "+" + str(offset);
+
+    // Codegen runs of constant stride, if shorter than the indices
+    if (g.compress) {
+      std::vector<casadi_int> runs = CodeGenerator::index_runs(nz);
+      if (runs.size()<nz.size()) {
+        std::string ind = g.constant(runs);
+        g.local("i", "casadi_int");
+        g << "for (cii=" << ind << ", rr=" << rr << ", "
+          << "ss=" << g.work(arg[1], this->dep(1).nnz()) << "; cii!=" << ind
+          << "+" << runs.size() << "; cii+=3) for (i=0; i<cii[2]; ++i, ++ss) ";
+        if (has_negative(this->nz_)) {
+          g << "if (cii[0]>=0) ";
+        }
+        g << "rr[cii[0]+i*cii[1]] " << (Add?"+=":"=") << " *ss;\n";
+        return;
+      }
+    }
+
+    // Condegen the indices
+    std::string ind = g.constant(nz);
+
+    // Perform the operation inplace
+    g << "for (cii=" << ind << ", rr=" << rr << ", "
       << "ss=" << g.work(arg[1], this->dep(1).nnz()) << "; cii!=" << ind
       << "+" << this->nz_.size() << "; ++cii, ++ss) ";
     if (has_negative(this->nz_)) {
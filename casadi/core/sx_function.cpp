@@ -29,6 +29,7 @@
 #include <deque>
 #include <sstream>
 #include <iomanip>
+#include <random>
 #include "sx_node.hpp"
 #include "casadi_common.hpp"
 #include "sparsity_internal.hpp"
@@ -145,31 +146,302 @@ namespace casadi {
   }
 
   void SXFunction::codegen_body(CodeGenerator& g) const {
+    casadi_int n = algorithm_.size();
+
+    // Instruction keys for loop re-rolling
+    std::vector<casadi_int> key, next;
+    if (g.reroll) {
+      key.resize(n);
+      next.resize(n);
+      std::unordered_map<casadi_int, casadi_int> last;
+      for (casadi_int k=n-1; k>=0; --k) {
+        const ScalarAtomic& a = algorithm_[k];
+        casadi_int io = a.op==OP_INPUT ? a.i1 : a.op==OP_OUTPUT ? a.i0 : -1;
+        key[k] = (io+1)*NUM_BUILT_IN_OPS + a.op;
+        auto it = last.find(key[k]);
+        next[k] = it==last.end() ? -1 : it->second;
+        last[key[k]] = k;
+      }
+    }
+
+    // Work vector elements stored in single precision
+    std::vector<bool> single;
+    if (g.mixed_precision>0 && !g.avoid_stack() && !g.reroll && !g.split
+        && g.casadi_real_type=="double") {
+      single = single_precision(g.mixed_precision, g.mixed_precision_range[0],
+        g.mixed_precision_range[1], g.mixed_precision_samples);
+    }
 
     // Run the algorithm
-    for (auto&& a : algorithm_) {
-      if (a.op==OP_OUTPUT) {
-        g << "if (res[" << a.i0 << "]!=0) "
-          << g.res(a.i0) << "[" << a.i2 << "]=" << g.sx_work(a.i1);
+    std::stringstream calls;
+    bool has_loop = false;
+    casadi_int k = 0;
+    while (k<n) {
+      // Repeated block?
+      casadi_int len = 0, rep = 0;
+      if (g.reroll) find_repeat(key, next, k, std::max(g.reroll, casadi_int(2)), len, rep);
+      if (rep>0) {
+        codegen_loop(g, k, len, rep);
+        k += len*rep;
+        has_loop = true;
+      } else {
+        const ScalarAtomic& a = algorithm_[k++];
+        codegen_instruction(g, a, str(a.i0), str(a.i1), str(a.i2),
+          a.op==OP_CONST ? g.constant(a.d) : "", single);
+      }
+
+      // Move the code so far to a separate function when splitting
+      if (g.split && k<n && static_cast<casadi_int>(g.buffer.tellp())>g.split) {
+        if (has_loop) {
+          std::string code = g.buffer.str();
+          g.buffer.str("");
+          g.buffer << "  casadi_int i;\n" << code;
+        }
+        calls << g.add_part("const casadi_real** arg, casadi_real** res, casadi_real* w")
+              << "(arg, res, w);\n";
+        has_loop = false;
+      }
+    }
+
+    // Call the split-off functions before the remaining code
+    if (!calls.str().empty()) {
+      std::string code = g.buffer.str();
+      g.buffer.str("");
+      g << calls.str();
+      g.buffer << code;
+    }
+    if (has_loop) g.local("i", "casadi_int");
+  }
+
+  void SXFunction::codegen_instruction(CodeGenerator& g, const ScalarAtomic& a,
+      const std::string& i0, const std::string& i1, const std::string& i2,
+      const std::string& d, const std::vector<bool>& single) const {
+    // Work vector element: local variable, or element of w for loops and split code
+    auto work = [&](casadi_int i, const std::string& s) {
+      return g.reroll || g.split ? "w[" + s + "]" : g.sx_work(i, !single.empty() && single[i]);
+    };
+    // Operand, single precision elements are promoted before the operation
+    auto operand = [&](casadi_int i, const std::string& s) {
+      if (single.empty() || !single[i]) return work(i, s);
+      return "((casadi_real)" + work(i, s) + ")";
+    };
+    if (a.op==OP_OUTPUT) {
+      g << "if (res[" << a.i0 << "]!=0) "
+        << g.res(a.i0) << "[" << i2 << "]=" << work(a.i1, i1);
+    } else {
+
+      // Where to store the result
+      g << work(a.i0, i0) << "=";
+
+      // What to store
+      if (a.op==OP_CONST) {
+        g << d;
+      } else if (a.op==OP_INPUT) {
+        g << g.arg(a.i1) << "? " << g.arg(a.i1) << "[" << i2 << "] : 0";
       } else {
+        casadi_int ndep = casadi_math<double>::ndeps(a.op);
+        casadi_assert_dev(ndep>0);
+        if (ndep==1) g << g.print_op(a.op, operand(a.i1, i1));
+        if (ndep==2) g << g.print_op(a.op, operand(a.i1, i1), operand(a.i2, i2));
+      }
+    }
+    g  << ";\n";
+  }
 
-        // Where to store the result
-        g << g.sx_work(a.i0) << "=";
+  void SXFunction::find_repeat(const std::vector<casadi_int>& key,
+      const std::vector<casadi_int>& next, casadi_int k, casadi_int min_rep,
+      casadi_int& len, casadi_int& rep) const {
+    // Limits on the block length and the number of candidate lengths tried
+    const casadi_int max_len = 1024, max_cand = 8;
+    casadi_int n = algorithm_.size();
+    len = rep = 0;
+    casadi_int m = next[k];
+    for (casadi_int c=0; c<max_cand && m>=0 && m-k<=max_len; ++c, m=next[m]) {
+      casadi_int L = m-k;
+      if (k+L*min_rep>n) break;
+      // Count consecutive repetitions of the block
+      casadi_int R = 1;
+      while (k+(R+1)*L<=n) {
+        casadi_int j;
+        for (j=0; j<L; ++j) {
+          if (key[k+R*L+j]!=key[k+j]) break;
+        }
+        if (j<L) break;
+        R++;
+      }
+      // Keep the candidate covering the most instructions
+      if (R>=min_rep && L*R>len*rep) {
+        len = L;
+        rep = R;
+      }
+    }
+  }
 
-        // What to store
+  void SXFunction::codegen_loop(CodeGenerator& g, casadi_int k, casadi_int len,
+      casadi_int rep) const {
+    // Columns of the index table and of the constant table, stored column by column
+    std::vector<casadi_int> itab;
+    std::vector<double> dtab;
+    std::vector<casadi_int> v(rep);
+    // Loop-invariant or affine operands become expressions, others table lookups
+    auto index = [&](casadi_int j, int field) -> std::string {
+      for (casadi_int r=0; r<rep; ++r) {
+        const ScalarAtomic& a = algorithm_[k+r*len+j];
+        v[r] = field==0 ? a.i0 : field==1 ? a.i1 : a.i2;
+      }
+      casadi_int stride = v[1]-v[0];
+      bool affine = true;
+      for (casadi_int r=2; r<rep && affine; ++r) affine = v[r]==v[0]+r*stride;
+      if (affine) {
+        if (stride==0) return str(v[0]);
+        return str(v[0]) + "+" + str(stride) + "*i";
+      }
+      std::string ret = "@I@[" + str(itab.size()) + "+i]";
+      itab.insert(itab.end(), v.begin(), v.end());
+      return ret;
+    };
+    auto constant = [&](casadi_int j) -> std::string {
+      double d0 = algorithm_[k+j].d;
+      bool same = true;
+      for (casadi_int r=1; r<rep && same; ++r) same = algorithm_[k+r*len+j].d==d0;
+      if (same) return g.constant(d0);
+      std::string ret = "@D@[" + str(dtab.size()) + "+i]";
+      for (casadi_int r=0; r<rep; ++r) dtab.push_back(algorithm_[k+r*len+j].d);
+      return ret;
+    };
+
+    // Operand expressions of the first block
+    std::vector<std::vector<std::string> > ops(len, std::vector<std::string>(4));
+    for (casadi_int j=0; j<len; ++j) {
+      const ScalarAtomic& a = algorithm_[k+j];
+      if (a.op==OP_OUTPUT) {
+        ops[j][1] = index(j, 1);
+        ops[j][2] = index(j, 2);
+      } else {
+        ops[j][0] = index(j, 0);
         if (a.op==OP_CONST) {
-          g << g.constant(a.d);
+          ops[j][3] = constant(j);
+        } else if (a.op==OP_INPUT) {
+          ops[j][2] = index(j, 2);
+        } else {
+          casadi_int ndep = casadi_math<double>::ndeps(a.op);
+          if (ndep>=1) ops[j][1] = index(j, 1);
+          if (ndep==2) ops[j][2] = index(j, 2);
+        }
+      }
+    }
+
+    // Tables
+    std::string iname = itab.empty() ? "" : g.constant(itab);
+    std::string dname = dtab.empty() ? "" : g.constant(dtab);
+    for (auto&& o : ops) {
+      for (auto&& e : o) {
+        std::string::size_type pos;
+        while ((pos=e.find("@I@"))!=std::string::npos) e.replace(pos, 3, iname);
+        while ((pos=e.find("@D@"))!=std::string::npos) e.replace(pos, 3, dname);
+      }
+    }
+
+    // Loop
+    g << "for (i=0; i<" << rep << "; ++i) {\n";
+    for (casadi_int j=0; j<len; ++j) {
+      codegen_instruction(g, algorithm_[k+j], ops[j][0], ops[j][1], ops[j][2], ops[j][3],
+        std::vector<bool>());
+    }
+    g << "}\n";
+  }
+
+  std::vector<bool> SXFunction::single_precision(double tol, double lb, double ub,
+      casadi_int n_sample) const {
+    // Unit roundoff of float
+    const double eps = std::ldexp(1., -24), inf = std::numeric_limits<double>::infinity();
+    casadi_int n = algorithm_.size(), nw = worksize_;
+    // Rounding error bound on the outputs for each work vector element
+    std::vector<double> err(nw, 0), err_k(nw);
+    // Values, producing instructions and absolute partial derivatives
+    std::vector<double> w(nw), v(n), adj(n), d(2*n);
+    std::vector<casadi_int> src(nw, -1), dep(2*n);
+    // Instructions producing the operands
+    for (casadi_int k=0; k<n; ++k) {
+      const ScalarAtomic& a = algorithm_[k];
+      dep[2*k] = dep[2*k+1] = -1;
+      if (a.op==OP_OUTPUT) {
+        dep[2*k] = src[a.i1];
+        continue;
+      } else if (a.op!=OP_CONST && a.op!=OP_INPUT) {
+        casadi_int ndep = casadi_math<double>::ndeps(a.op);
+        dep[2*k] = src[a.i1];
+        if (ndep==2) dep[2*k+1] = src[a.i2];
+      }
+      src[a.i0] = k;
+    }
+    // Discontinuous operations have zero sensitivity almost everywhere, but rounding
+    // their operands can still flip a branch: keep them, and all they depend on, in double
+    std::vector<bool> exact(n, false);
+    for (casadi_int k=n-1; k>=0; --k) {
+      if (exact[k] || !operation_checker<SmoothChecker>(algorithm_[k].op)) {
+        for (casadi_int i=0; i<2; ++i) {
+          if (dep[2*k+i]>=0) exact[dep[2*k+i]] = true;
+        }
+      }
+    }
+    std::default_random_engine rng(0);
+    std::uniform_real_distribution<double> unif(lb, ub);
+    for (casadi_int s=0; s<n_sample; ++s) {
+      // Forward sweep with sampled inputs
+      for (casadi_int k=0; k<n; ++k) {
+        const ScalarAtomic& a = algorithm_[k];
+        if (a.op==OP_OUTPUT) {
+          continue;
+        } else if (a.op==OP_CONST) {
+          v[k] = a.d;
         } else if (a.op==OP_INPUT) {
-          g << g.arg(a.i1) << "? " << g.arg(a.i1) << "[" << a.i2 << "] : 0";
+          v[k] = unif(rng);
         } else {
           casadi_int ndep = casadi_math<double>::ndeps(a.op);
-          casadi_assert_dev(ndep>0);
-          if (ndep==1) g << g.print_op(a.op, g.sx_work(a.i1));
-          if (ndep==2) g << g.print_op(a.op, g.sx_work(a.i1), g.sx_work(a.i2));
+          double x = w[a.i1], y = ndep==2 ? w[a.i2] : 0, dd[2] = {0, 0};
+          casadi_math<double>::fun(a.op, x, y, v[k]);
+          casadi_math<double>::der(a.op, x, y, v[k], dd);
+          d[2*k] = std::fabs(dd[0]);
+          d[2*k+1] = std::fabs(dd[1]);
+        }
+        w[a.i0] = v[k];
+      }
+      // Reverse sweep: sum over the outputs of the absolute sensitivities
+      std::fill(adj.begin(), adj.end(), 0);
+      for (casadi_int k=n-1; k>=0; --k) {
+        if (algorithm_[k].op==OP_OUTPUT) {
+          if (dep[2*k]>=0) adj[dep[2*k]] += 1;
+        } else if (adj[k]!=0) {
+          for (casadi_int i=0; i<2; ++i) {
+            if (dep[2*k+i]>=0) adj[dep[2*k+i]] += d[2*k+i]*adj[k];
+          }
         }
       }
-      g  << ";\n";
+      // Rounding error of every value stored, accumulated per work vector element
+      std::fill(err_k.begin(), err_k.end(), 0);
+      for (casadi_int k=0; k<n; ++k) {
+        const ScalarAtomic& a = algorithm_[k];
+        if (a.op==OP_OUTPUT) continue;
+        double e = adj[k]*std::fabs(v[k])*eps;
+        if (exact[k] || !(e<inf) || std::fabs(v[k])>std::numeric_limits<float>::max()) e = inf;
+        err_k[a.i0] += e;
+      }
+      for (casadi_int i=0; i<nw; ++i) err[i] = std::max(err[i], err_k[i]);
+    }
+    // Least sensitive elements first, within the error budget
+    std::vector<casadi_int> order(nw);
+    for (casadi_int i=0; i<nw; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+      [&](casadi_int i, casadi_int j) { return err[i]<err[j];});
+    std::vector<bool> ret(nw, false);
+    double total = 0;
+    for (casadi_int i : order) {
+      if (!(total+err[i]<=tol)) break;
+      total += err[i];
+      ret[i] = true;
     }
+    return ret;
   }
 
   const Options SXFunction::options_
@@ -270,6 +270,30 @@ class CASADI_EXPORT SXFunction :
       \identifier{v5} */
   void codegen_body(CodeGenerator& g) const override;
 
+  /** \brief Generate code for one instruction, operands given as C expressions */
+  void codegen_instruction(CodeGenerator& g, const ScalarAtomic& a,
+    const std::string& i0, const std::string& i1, const std::string& i2,
+    const std::string& d, const std::vector<bool>& single) const;
+
+  /** \brief Work vector elements that can be stored in single precision
+
+      Linearized rounding error analysis at n_sample inputs sampled uniformly
+      in [lb, ub], with the total error bound on the outputs kept below tol
+  */
+  std::vector<bool> single_precision(double tol, double lb, double ub,
+    casadi_int n_sample) const;
+
+  /** \brief Find the longest run of a repeated instruction block starting at k
+
+      key: operation (and input/output index) of each instruction,
+      next: next instruction with the same key, -1 if none
+  */
+  void find_repeat(const std::vector<casadi_int>& key, const std::vector<casadi_int>& next,
+    casadi_int k, casadi_int min_rep, casadi_int& len, casadi_int& rep) const;
+
+  /** \brief Generate a repeated instruction block as a loop over index tables */
+  void codegen_loop(CodeGenerator& g, casadi_int k, casadi_int len, casadi_int rep) const;
+
   /** \brief  Propagate sparsity forward
 
       \identifier{v6} */
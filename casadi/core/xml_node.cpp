@@ -25,6 +25,7 @@
 
 #include "xml_node.hpp"
 #include "casadi_misc.hpp"
+#include "serializing_stream.hpp"
 
 namespace casadi {
 
@@ -168,4 +169,28 @@ std::vector<std::string> XmlNode::attribute_names() const {
   return ret;
 }
 
+void XmlNode::serialize(SerializingStream& s) const {
+  s.pack("XmlNode::name", name);
+  s.pack("XmlNode::attributes", attributes);
+  s.pack("XmlNode::comment", comment);
+  s.pack("XmlNode::line", line);
+  s.pack("XmlNode::text", text);
+  s.pack("XmlNode::n_children", static_cast<casadi_int>(children.size()));
+  for (const XmlNode& c : children) c.serialize(s);
+}
+
+XmlNode XmlNode::deserialize(DeserializingStream& s) {
+  XmlNode ret;
+  s.unpack("XmlNode::name", ret.name);
+  s.unpack("XmlNode::attributes", ret.attributes);
+  s.unpack("XmlNode::comment", ret.comment);
+  s.unpack("XmlNode::line", ret.line);
+  s.unpack("XmlNode::text", ret.text);
+  casadi_int n_children;
+  s.unpack("XmlNode::n_children", n_children);
+  ret.children.reserve(n_children);
+  for (casadi_int i = 0; i < n_children; ++i) ret.children.push_back(deserialize(s));
+  return ret;
+}
+
 } // namespace casadi
@@ -36,6 +36,10 @@
 
 namespace casadi {
 
+// Forward declarations
+class SerializingStream;
+class DeserializingStream;
+
 struct CASADI_EXPORT XmlNode {
   // All attributes
   std::map<std::string, std::string> attributes;
@@ -199,6 +203,12 @@ struct CASADI_EXPORT XmlNode {
 
       \identifier{vw} */
   void dump(std::ostream &stream, casadi_int indent = 0) const;
+
+  // Serialize, including all children
+  void serialize(SerializingStream& s) const;
+
+  // Deserialize, including all children
+  static XmlNode deserialize(DeserializingStream& s);
 };
 
 } // namespace casadi
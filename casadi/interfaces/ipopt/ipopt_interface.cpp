@@ -132,7 +132,14 @@ namespace casadi {
         "abstol: use inactive_lam_value"}},
       {"inactive_lam_value",
        {OT_DOUBLE,
-        "Value used in inactive_lam_strategy (default: 10)."}}
+        "Value used in inactive_lam_strategy (default: 10)."}},
+      {"fused_oracle",
+       {OT_BOOL,
+        "Evaluate objective, constraints, gradient and constraint Jacobian "
+        "in a single function call whenever IPOPT passes a new x and serve the "
+        "subsequent callbacks at the same x from the cached results (default: false). "
+        "Beneficial when the derivative calculations share most work with the "
+        "nominal evaluation."}}
      }
   };
 
@@ -150,6 +157,7 @@ namespace casadi {
     clip_inactive_lam_ = false;
     inactive_lam_strategy_ = "reltol";
     inactive_lam_value_ = 10;
+    fused_oracle_ = false;
 
     // Read user options
     for (auto&& op : opts) {
@@ -196,6 +204,8 @@ namespace casadi {
         inactive_lam_strategy_ = op.second.to_string();
       } else if (op.first=="inactive_lam_value") {
         inactive_lam_value_ = op.second;
+      } else if (op.first=="fused_oracle") {
+        fused_oracle_ = op.second;
       }
     }
 
@@ -216,6 +226,11 @@ namespace casadi {
       create_function("nlp_jac_g", {"x", "p"}, {"g", "jac:g:x"});
     }
     jacg_sp_ = get_function("nlp_jac_g").sparsity_out(1);
+    if (fused_oracle_) {
+      create_function("nlp_fused", {"x", "p"}, {"f", "g", "grad:f:x", "jac:g:x"});
+      casadi_assert(get_function("nlp_fused").sparsity_out(3) == jacg_sp_,
+        "Fused oracle requires the default constraint Jacobian sparsity pattern");
+    }
 
     convexify_ = false;
 
@@ -251,6 +266,12 @@ namespace casadi {
       alloc_iw(convexify_data_.sz_iw);
       alloc_w(convexify_data_.sz_w);
     }
+    if (fused_oracle_) {
+      alloc_w(1, true); // fused_f
+      alloc_w(ng_, true); // fused_g
+      alloc_w(nx_, true); // fused_grad_f
+      alloc_w(jacg_sp_.nnz(), true); // fused_jac_g
+    }
   }
 
   int IpoptInterface::init_mem(void* mem) const {
@@ -369,6 +390,27 @@ namespace casadi {
     if (exact_hessian_) {
       m->hess_lk = w; w += hesslag_sp_.nnz();
     }
+    if (fused_oracle_) {
+      m->fused_f = w; w += 1;
+      m->fused_g = w; w += ng_;
+      m->fused_grad_f = w; w += nx_;
+      m->fused_jac_g = w; w += jacg_sp_.nnz();
+    }
+  }
+
+  int IpoptInterface::eval_fused(IpoptMemory* m, const double* x, bool new_x) const {
+    // Quick return if cached results available
+    if (!new_x && m->fused_valid) return 0;
+    m->fused_valid = false;
+    m->arg[0] = x;
+    m->arg[1] = m->d_nlp.p;
+    m->res[0] = m->fused_f;
+    m->res[1] = m->fused_g;
+    m->res[2] = m->fused_grad_f;
+    m->res[3] = m->fused_jac_g;
+    if (calc_function(m, "nlp_fused")) return 1;
+    m->fused_valid = true;
+    return 0;
   }
 
   inline const char* return_status_string(Ipopt::ApplicationReturnStatus status) {
@@ -437,6 +479,9 @@ namespace casadi {
     // Reset number of iterations
     m->n_iter = 0;
 
+    // No cached oracle results
+    m->fused_valid = false;
+
     // Get back the smart pointers
     Ipopt::SmartPtr<Ipopt::TNLP> *userclass =
       static_cast<Ipopt::SmartPtr<Ipopt::TNLP>*>(m->userclass);
@@ -705,6 +750,7 @@ namespace casadi {
     this->app = nullptr;
     this->userclass = nullptr;
     this->return_status = "Unset";
+    this->fused_valid = false;
   }
 
   IpoptMemory::~IpoptMemory() {
@@ -740,7 +786,7 @@ namespace casadi {
   }
 
   IpoptInterface::IpoptInterface(DeserializingStream& s) : Nlpsol(s) {
-    int version = s.version("IpoptInterface", 1, 3);
+    int version = s.version("IpoptInterface", 1, 4);
     s.unpack("IpoptInterface::jacg_sp", jacg_sp_);
     s.unpack("IpoptInterface::hesslag_sp", hesslag_sp_);
     s.unpack("IpoptInterface::exact_hessian", exact_hessian_);
@@ -767,11 +813,16 @@ namespace casadi {
       inactive_lam_strategy_ = "reltol";
       inactive_lam_value_ = 10;
     }
+    if (version>=4) {
+      s.unpack("IpoptInterface::fused_oracle", fused_oracle_);
+    } else {
+      fused_oracle_ = false;
+    }
   }
 
   void IpoptInterface::serialize_body(SerializingStream &s) const {
     Nlpsol::serialize_body(s);
-    s.version("IpoptInterface", 3);
+    s.version("IpoptInterface", 4);
     s.pack("IpoptInterface::jacg_sp", jacg_sp_);
     s.pack("IpoptInterface::hesslag_sp", hesslag_sp_);
     s.pack("IpoptInterface::exact_hessian", exact_hessian_);
@@ -790,6 +841,7 @@ namespace casadi {
     s.pack("IpoptInterface::clip_inactive_lam", clip_inactive_lam_);
     s.pack("IpoptInterface::inactive_lam_strategy", inactive_lam_strategy_);
     s.pack("IpoptInterface::inactive_lam_value", inactive_lam_value_);
+    s.pack("IpoptInterface::fused_oracle", fused_oracle_);
 
   }
 
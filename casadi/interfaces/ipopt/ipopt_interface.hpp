@@ -77,6 +77,10 @@ namespace casadi {
     // Current calculated quantities
     double *gk, *grad_fk, *jac_gk, *hess_lk, *grad_lk;
 
+    // Cached results of the fused oracle, valid until Ipopt signals a new x
+    double *fused_f, *fused_g, *fused_grad_f, *fused_jac_g;
+    bool fused_valid;
+
     // Stats
     std::vector<double> inf_pr, inf_du, mu, d_norm, regularization_size,
       obj, alpha_pr, alpha_du;
@@ -203,6 +207,12 @@ namespace casadi {
     /// convexify?
     bool convexify_;
 
+    /// Evaluate f, g, grad_f and jac_g in a single call
+    bool fused_oracle_;
+
+    /// Update the fused oracle cache, if needed
+    int eval_fused(IpoptMemory* m, const double* x, bool new_x) const;
+
     void set_ipopt_prob(CodeGenerator& g) const;
 
     /** \brief Generate code for the function body */
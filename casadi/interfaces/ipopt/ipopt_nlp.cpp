@@ -86,10 +86,15 @@ namespace casadi {
 
   // returns the value of the objective function
   bool IpoptUserClass::eval_f(Index n, const Number* x, bool new_x, Number& obj_value) {
-    mem_->arg[0] = x;
-    mem_->arg[1] = mem_->d_nlp.p;
-    mem_->res[0] = &obj_value;
     try {
+      if (solver_.fused_oracle_) {
+        if (solver_.eval_fused(mem_, x, new_x)) return false;
+        obj_value = *mem_->fused_f;
+        return true;
+      }
+      mem_->arg[0] = x;
+      mem_->arg[1] = mem_->d_nlp.p;
+      mem_->res[0] = &obj_value;
       return solver_.calc_function(mem_, "nlp_f")==0;
     } catch(KeyboardInterruptException& ex) {
       casadi_warning("KeyboardInterruptException");
@@ -104,11 +109,16 @@ namespace casadi {
 
   // return the gradient of the objective function grad_ {x} f(x)
   bool IpoptUserClass::eval_grad_f(Index n, const Number* x, bool new_x, Number* grad_f) {
-    mem_->arg[0] = x;
-    mem_->arg[1] = mem_->d_nlp.p;
-    mem_->res[0] = nullptr;
-    mem_->res[1] = grad_f;
     try {
+      if (solver_.fused_oracle_) {
+        if (solver_.eval_fused(mem_, x, new_x)) return false;
+        casadi_copy(mem_->fused_grad_f, n, grad_f);
+        return true;
+      }
+      mem_->arg[0] = x;
+      mem_->arg[1] = mem_->d_nlp.p;
+      mem_->res[0] = nullptr;
+      mem_->res[1] = grad_f;
       return solver_.calc_function(mem_, "nlp_grad_f")==0;
     } catch(KeyboardInterruptException& ex) {
       casadi_warning("KeyboardInterruptException");
@@ -123,10 +133,15 @@ namespace casadi {
 
   // return the value of the constraints: g(x)
   bool IpoptUserClass::eval_g(Index n, const Number* x, bool new_x, Index m, Number* g) {
-    mem_->arg[0] = x;
-    mem_->arg[1] = mem_->d_nlp.p;
-    mem_->res[0] = g;
     try {
+      if (solver_.fused_oracle_) {
+        if (solver_.eval_fused(mem_, x, new_x)) return false;
+        casadi_copy(mem_->fused_g, m, g);
+        return true;
+      }
+      mem_->arg[0] = x;
+      mem_->arg[1] = mem_->d_nlp.p;
+      mem_->res[0] = g;
       return solver_.calc_function(mem_, "nlp_g")==0;
     } catch(KeyboardInterruptException& ex) {
       casadi_warning("KeyboardInterruptException");
@@ -145,11 +160,16 @@ namespace casadi {
                                   Number* values) {
     if (values) {
       // Evaluate numerically
-      mem_->arg[0] = x;
-      mem_->arg[1] = mem_->d_nlp.p;
-      mem_->res[0] = nullptr;
-      mem_->res[1] = values;
       try {
+        if (solver_.fused_oracle_) {
+          if (solver_.eval_fused(mem_, x, new_x)) return false;
+          casadi_copy(mem_->fused_jac_g, nele_jac, values);
+          return true;
+        }
+        mem_->arg[0] = x;
+        mem_->arg[1] = mem_->d_nlp.p;
+        mem_->res[0] = nullptr;
+        mem_->res[1] = values;
         return solver_.calc_function(mem_, "nlp_jac_g")==0;
       } catch(KeyboardInterruptException& ex) {
         casadi_warning("KeyboardInterruptException");
@@ -0,0 +1,430 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "condensing.hpp"
+#include "casadi/core/conic.hpp"
+
+namespace casadi {
+
+  extern "C"
+  int CASADI_CONIC_CONDENSING_EXPORT
+  casadi_register_conic_condensing(Conic::Plugin* plugin) {
+    plugin->creator = Condensing::creator;
+    plugin->name = "condensing";
+    plugin->doc = Condensing::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &Condensing::options_;
+    plugin->deserialize = &Condensing::deserialize;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_CONIC_CONDENSING_EXPORT casadi_load_conic_condensing() {
+    Conic::registerPlugin(casadi_register_conic_condensing);
+  }
+
+  Condensing::Condensing(const std::string& name, const std::map<std::string, Sparsity> &st)
+    : Conic(name, st) {
+  }
+
+  Condensing::~Condensing() {
+    clear_mem();
+  }
+
+  void* Condensing::alloc_mem() const {
+    CondensingMemory *m = new CondensingMemory();
+    m->qp_mem = solver_.checkout();
+    return m;
+  }
+
+  void Condensing::free_mem(void *mem) const {
+    auto m = static_cast<CondensingMemory*>(mem);
+    solver_.release(m->qp_mem);
+    delete m;
+  }
+
+  const Options Condensing::options_
+  = {{&Conic::options_},
+     {{"conic",
+       {OT_STRING,
+        "Name of the QP solver for the condensed problem"}},
+      {"conic_options",
+       {OT_DICT,
+        "Options to be passed to the QP solver"}},
+      {"N",
+       {OT_INT,
+        "OCP horizon"}},
+      {"nx",
+       {OT_INTVECTOR,
+        "Number of states, length N+1"}},
+      {"nu",
+       {OT_INTVECTOR,
+        "Number of controls, length N or N+1"}},
+      {"ng",
+       {OT_INTVECTOR,
+        "Number of non-dynamic constraints, length N+1"}},
+      {"block_size",
+       {OT_INT,
+        "Number of stages per condensed block. States are kept at multiples of "
+        "the block size (partial condensing). Default 0: full condensing, only "
+        "x0 is kept."}}
+     }
+  };
+
+  void Condensing::init(const Dict& opts) {
+    // Initialize the base classes
+    Conic::init(opts);
+
+    // Default options
+    std::string conic_plugin;
+    Dict conic_options;
+    casadi_int N = -1, block_size = 0;
+    std::vector<casadi_int> nx, nu, ng;
+
+    // Read user options
+    for (auto&& op : opts) {
+      if (op.first=="conic") {
+        conic_plugin = op.second.to_string();
+      } else if (op.first=="conic_options") {
+        conic_options = op.second;
+      } else if (op.first=="N") {
+        N = op.second;
+      } else if (op.first=="nx") {
+        nx = op.second;
+      } else if (op.first=="nu") {
+        nu = op.second;
+      } else if (op.first=="ng") {
+        ng = op.second;
+      } else if (op.first=="block_size") {
+        block_size = op.second;
+      }
+    }
+
+    // Consistency checks
+    casadi_assert(!conic_plugin.empty(), "'conic' option has not been set");
+    casadi_assert(N>=1, "Option 'N' must be set to a positive horizon");
+    if (nu.size()==N) nu.push_back(0);
+    casadi_assert(nx.size()==N+1 && nu.size()==N+1 && ng.size()==N+1,
+      "Options 'nx' and 'ng' must have length N+1 and 'nu' length N or N+1. "
+      "Structure is: N " + str(N) + ", nx " + str(nx) + ", nu " + str(nu) + ", "
+      "ng " + str(ng) + ".");
+    casadi_assert(np_==0, "Condensing does not support conic constraints");
+    for (bool d : discrete_) casadi_assert(!d, "Condensing does not support discrete variables");
+
+    // Offsets of the stage variables, dynamics and path constraints
+    std::vector<casadi_int> off_x(N+1), off_d(N), off_g(N+1);
+    casadi_int offset = 0;
+    for (casadi_int k=0; k<=N; ++k) {
+      off_x[k] = offset;
+      offset += nx[k] + nu[k];
+    }
+    casadi_assert(offset==nx_,
+      "sum(nx)+sum(nu) = must equal total size of variables (" + str(nx_) + "). "
+      "Structure is: N " + str(N) + ", nx " + str(nx) + ", nu " + str(nu) + ", "
+      "ng " + str(ng) + ".");
+    offset = 0;
+    for (casadi_int k=0; k<=N; ++k) {
+      if (k<N) {
+        off_d[k] = offset;
+        offset += nx[k+1];
+      }
+      off_g[k] = offset;
+      offset += ng[k];
+    }
+    casadi_assert(offset==na_,
+      "sum(nx+1)+sum(ng) = must equal total size of constraints (" + str(na_) + "). "
+      "Structure is: N " + str(N) + ", nx " + str(nx) + ", nu " + str(nu) + ", "
+      "ng " + str(ng) + ".");
+
+    // Stage of each variable, and for dynamics rows the next state they define
+    std::vector<casadi_int> var_stage(nx_), row_stage(na_), row_next(na_, -1);
+    for (casadi_int k=0; k<=N; ++k) {
+      for (casadi_int i=0; i<nx[k]+nu[k]; ++i) var_stage[off_x[k]+i] = k;
+      for (casadi_int i=0; i<ng[k]; ++i) row_stage[off_g[k]+i] = k;
+      if (k<N) {
+        for (casadi_int i=0; i<nx[k+1]; ++i) {
+          row_stage[off_d[k]+i] = k;
+          row_next[off_d[k]+i] = off_x[k+1]+i;
+        }
+      }
+    }
+
+    // Each row may only depend on the variables of its stage, and dynamics rows
+    // on one entry of the next state
+    const casadi_int* colind = A_.colind();
+    const casadi_int* row = A_.row();
+    std::vector<bool> has_next(na_, false);
+    for (casadi_int c=0; c<nx_; ++c) {
+      for (casadi_int el=colind[c]; el<colind[c+1]; ++el) {
+        casadi_int r = row[el];
+        if (row_next[r]==c) {
+          has_next[r] = true;
+        } else {
+          casadi_assert(var_stage[c]==row_stage[r],
+            "Condensing: specified structure of A does not correspond to what the plugin "
+            "can handle. Entry (" + str(r) + ", " + str(c) + ") couples different stages. "
+            "Structure is: N " + str(N) + ", nx " + str(nx) + ", nu " + str(nu) + ", "
+            "ng " + str(ng) + ".");
+        }
+      }
+    }
+    for (casadi_int r=0; r<na_; ++r) {
+      casadi_assert(row_next[r]<0 || has_next[r],
+        "Condensing: dynamics constraint " + str(r) + " does not depend on the next state");
+    }
+
+    // States that are eliminated
+    if (block_size<=0) block_size = N+1;
+    std::vector<bool> elim_x(N+1, false);
+    for (casadi_int k=1; k<=N; ++k) elim_x[k] = k % block_size != 0;
+
+    // Variables, constraints and state bounds of the condensed QP
+    std::vector<casadi_int> keep, keep_rows, elim_vars;
+    elim_rows_.clear();
+    for (casadi_int k=0; k<=N; ++k) {
+      for (casadi_int i=0; i<nx[k]; ++i) {
+        (elim_x[k] ? elim_vars : keep).push_back(off_x[k]+i);
+      }
+      for (casadi_int i=0; i<nu[k]; ++i) keep.push_back(off_x[k]+nx[k]+i);
+      if (k<N) {
+        for (casadi_int i=0; i<nx[k+1]; ++i) {
+          (elim_x[k+1] ? elim_rows_ : keep_rows).push_back(off_d[k]+i);
+        }
+      }
+      for (casadi_int i=0; i<ng[k]; ++i) keep_rows.push_back(off_g[k]+i);
+    }
+    casadi_int ny = keep.size();
+
+    // Symbolic QP data
+    SX h = SX::sym("h", H_), g = SX::sym("g", nx_), a = SX::sym("a", A_);
+    SX lba = SX::sym("lba", na_), uba = SX::sym("uba", na_);
+    SX lbx = SX::sym("lbx", nx_), ubx = SX::sym("ubx", nx_), x0 = SX::sym("x0", nx_);
+    const std::vector<SXElem>& a_nz = a.nonzeros();
+    const std::vector<SXElem>& lba_nz = lba.nonzeros();
+
+    // Full decision vector as an affine function of the condensed one,
+    // eliminating states forward in time using the dynamics
+    SX y = SX::sym("y", ny);
+    const std::vector<SXElem>& y_nz = y.nonzeros();
+    std::vector<SXElem> z_nz(nx_);
+    for (casadi_int i=0; i<ny; ++i) z_nz[keep[i]] = y_nz[i];
+    std::vector<casadi_int> mapping;
+    Sparsity AT = A_.transpose(mapping);
+    for (casadi_int r : elim_rows_) {
+      SXElem rhs = lba_nz[r], d = 0;
+      for (casadi_int el=AT.colind()[r]; el<AT.colind()[r+1]; ++el) {
+        casadi_int c = AT.row()[el];
+        if (c==row_next[r]) {
+          d = a_nz[mapping[el]];
+        } else {
+          rhs -= a_nz[mapping[el]] * z_nz[c];
+        }
+      }
+      z_nz[row_next[r]] = rhs / d;
+    }
+    SX z = z_nz;
+    SX T = SX::jacobian(z, y);
+    SX t = SX::substitute(z, y, SX::zeros(ny));
+
+    // Condensed objective
+    SX Ht = mtimes(h, t);
+    SX H_r = mtimes(T.T(), mtimes(h, T));
+    SX g_r = mtimes(T.T(), g + Ht);
+    SX c0 = 0.5*dot(t, Ht) + dot(g, t);
+
+    // Condensed constraints: remaining rows of A, then bounds on eliminated states
+    SX A_keep = a(keep_rows, Slice());
+    SX A_r = vertcat(mtimes(A_keep, T), T(elim_vars, Slice()));
+    SX At = mtimes(A_keep, t);
+    SX lba_r = vertcat(lba(keep_rows) - At, lbx(elim_vars) - t(elim_vars));
+    SX uba_r = vertcat(uba(keep_rows) - At, ubx(elim_vars) - t(elim_vars));
+
+    condense_ = Function(name_ + "_condense", {h, g, a, lba, uba, lbx, ubx, x0},
+      {H_r, densify(g_r), A_r, densify(lba_r), densify(uba_r),
+       lbx(keep), ubx(keep), x0(keep), densify(c0)});
+
+    // Multipliers of the full QP: the eliminated dynamics multipliers follow
+    // from stationarity w.r.t. the eliminated states, backward in time
+    SX lam_y = SX::sym("lam_y", ny), lam_ar = SX::sym("lam_ar", A_r.size1());
+    const std::vector<SXElem>& lam_y_nz = lam_y.nonzeros();
+    const std::vector<SXElem>& lam_ar_nz = lam_ar.nonzeros();
+    std::vector<SXElem> lam_x_nz(nx_, 0), lam_a_nz(na_, 0);
+    for (casadi_int i=0; i<ny; ++i) lam_x_nz[keep[i]] = lam_y_nz[i];
+    for (casadi_int i=0; i<keep_rows.size(); ++i) lam_a_nz[keep_rows[i]] = lam_ar_nz[i];
+    for (casadi_int i=0; i<elim_vars.size(); ++i) {
+      lam_x_nz[elim_vars[i]] = lam_ar_nz[keep_rows.size()+i];
+    }
+    SX grad = densify(mtimes(h, z) + g) + SX(lam_x_nz);
+    const std::vector<SXElem>& grad_nz = grad.nonzeros();
+    for (auto it=elim_rows_.rbegin(); it!=elim_rows_.rend(); ++it) {
+      casadi_int r = *it, c = row_next[r];
+      SXElem res = grad_nz[c], d = 0;
+      for (casadi_int el=colind[c]; el<colind[c+1]; ++el) {
+        if (row[el]==r) {
+          d = a_nz[el];
+        } else {
+          res += a_nz[el] * lam_a_nz[row[el]];
+        }
+      }
+      lam_a_nz[r] = -res / d;
+    }
+
+    expand_ = Function(name_ + "_expand", {h, g, a, lba, y, lam_y, lam_ar},
+      {z, SX(lam_x_nz), SX(lam_a_nz)});
+
+    if (verbose_) {
+      casadi_message("Condensed QP: " + str(ny) + " variables (was " + str(nx_) + "), "
+        + str(A_r.size1()) + " constraints (was " + str(na_) + ").");
+    }
+
+    // QP solver for the condensed problem
+    solver_ = conic(name_ + "_qp", conic_plugin,
+                    {{"h", H_r.sparsity()}, {"a", A_r.sparsity()}}, conic_options);
+
+    // Allocate memory
+    alloc(condense_);
+    alloc(expand_);
+    alloc(solver_);
+    alloc_w(solver_.nnz_in(CONIC_H) + solver_.nnz_in(CONIC_A)
+            + 4*ny + 2*A_r.size1() + 1, true); // condensed QP data
+    alloc_w(2*ny + A_r.size1() + 1, true); // condensed QP solution
+  }
+
+  int Condensing::
+  solve(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
+    auto m = static_cast<CondensingMemory*>(mem);
+
+    // Dynamics must be equalities to be eliminated
+    const double *lba = arg[CONIC_LBA], *uba = arg[CONIC_UBA];
+    for (casadi_int r : elim_rows_) {
+      casadi_assert((lba ? lba[r] : 0) == (uba ? uba[r] : 0),
+        "Condensing: dynamics constraint " + str(r) + " must be an equality constraint");
+    }
+
+    // Condensed QP data
+    casadi_int ny = solver_.nnz_in(CONIC_G), na = solver_.nnz_in(CONIC_LBA);
+    double* h_r = w; w += solver_.nnz_in(CONIC_H);
+    double* g_r = w; w += ny;
+    double* a_r = w; w += solver_.nnz_in(CONIC_A);
+    double* lba_r = w; w += na;
+    double* uba_r = w; w += na;
+    double* lbx_r = w; w += ny;
+    double* ubx_r = w; w += ny;
+    double* y0 = w; w += ny;
+    double* c0 = w; w += 1;
+
+    // Condensed QP solution
+    double* y = w; w += ny;
+    double* lam_y = w; w += ny;
+    double* lam_ar = w; w += na;
+    double* cost_r = w; w += 1;
+
+    // Buffers for calling the condensing functions and the QP solver
+    const double** arg1 = arg + n_in_;
+    double** res1 = res + n_out_;
+
+    // Condense
+    arg1[0] = arg[CONIC_H];
+    arg1[1] = arg[CONIC_G];
+    arg1[2] = arg[CONIC_A];
+    arg1[3] = arg[CONIC_LBA];
+    arg1[4] = arg[CONIC_UBA];
+    arg1[5] = arg[CONIC_LBX];
+    arg1[6] = arg[CONIC_UBX];
+    arg1[7] = arg[CONIC_X0];
+    res1[0] = h_r;
+    res1[1] = g_r;
+    res1[2] = a_r;
+    res1[3] = lba_r;
+    res1[4] = uba_r;
+    res1[5] = lbx_r;
+    res1[6] = ubx_r;
+    res1[7] = y0;
+    res1[8] = c0;
+    if (condense_(arg1, res1, iw, w)) return 1;
+
+    // Solve the condensed QP
+    std::fill_n(arg1, static_cast<casadi_int>(CONIC_NUM_IN), nullptr);
+    std::fill_n(res1, static_cast<casadi_int>(CONIC_NUM_OUT), nullptr);
+    arg1[CONIC_H] = h_r;
+    arg1[CONIC_G] = g_r;
+    arg1[CONIC_A] = a_r;
+    arg1[CONIC_LBA] = lba_r;
+    arg1[CONIC_UBA] = uba_r;
+    arg1[CONIC_LBX] = lbx_r;
+    arg1[CONIC_UBX] = ubx_r;
+    arg1[CONIC_X0] = y0;
+    res1[CONIC_X] = y;
+    res1[CONIC_COST] = cost_r;
+    res1[CONIC_LAM_A] = lam_ar;
+    res1[CONIC_LAM_X] = lam_y;
+    int ret = solver_(arg1, res1, iw, w, m->qp_mem);
+    auto qp_m = static_cast<ConicMemory*>(solver_.memory(m->qp_mem));
+    m->d_qp.success = qp_m->d_qp.success;
+    m->d_qp.unified_return_status = qp_m->d_qp.unified_return_status;
+
+    // Expand the solution
+    arg1[0] = arg[CONIC_H];
+    arg1[1] = arg[CONIC_G];
+    arg1[2] = arg[CONIC_A];
+    arg1[3] = arg[CONIC_LBA];
+    arg1[4] = y;
+    arg1[5] = lam_y;
+    arg1[6] = lam_ar;
+    res1[0] = res[CONIC_X];
+    res1[1] = res[CONIC_LAM_X];
+    res1[2] = res[CONIC_LAM_A];
+    if (expand_(arg1, res1, iw, w)) return 1;
+    if (res[CONIC_COST]) *res[CONIC_COST] = *cost_r + *c0;
+    return ret;
+  }
+
+  Dict Condensing::get_stats(void* mem) const {
+    Dict stats = Conic::get_stats(mem);
+    auto m = static_cast<CondensingMemory*>(mem);
+    stats["solver_stats"] = solver_.stats(m->qp_mem);
+    return stats;
+  }
+
+  Condensing::Condensing(DeserializingStream& s) : Conic(s) {
+    s.version("Condensing", 1);
+    s.unpack("Condensing::solver", solver_);
+    s.unpack("Condensing::condense", condense_);
+    s.unpack("Condensing::expand", expand_);
+    s.unpack("Condensing::elim_rows", elim_rows_);
+  }
+
+  void Condensing::serialize_body(SerializingStream &s) const {
+    Conic::serialize_body(s);
+
+    s.version("Condensing", 1);
+    s.pack("Condensing::solver", solver_);
+    s.pack("Condensing::condense", condense_);
+    s.pack("Condensing::expand", expand_);
+    s.pack("Condensing::elim_rows", elim_rows_);
+  }
+
+} // namespace casadi
@@ -0,0 +1,135 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_CONDENSING_HPP
+#define CASADI_CONDENSING_HPP
+
+#include "casadi/core/conic_impl.hpp"
+#include <casadi/solvers/casadi_conic_condensing_export.h>
+
+
+/** \defgroup plugin_Conic_condensing Title
+    \par
+
+   Condensing preprocessor for QPs with optimal control structure
+
+   The decision variables are ordered as x0, u0, x1, u1, ..., xN, uN and the
+   constraints as the dynamics of stage 0, the path constraints of stage 0,
+   ..., the path constraints of stage N, using the same layout as the 'hpipm'
+   plugin (options 'N', 'nx', 'nu', 'ng').
+
+   States are eliminated using the dynamics, which must be equality
+   constraints that are explicit in the next state. The condensed, smaller
+   and denser QP is solved with the Conic plugin given by the 'conic' option
+   and the solution is expanded afterwards. With 'block_size' > 0, only the
+   states inside blocks of that many stages are eliminated (partial
+   condensing). Bounds on eliminated states become linear constraints. */
+
+/** \pluginsection{Conic,condensing} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  struct CASADI_CONIC_CONDENSING_EXPORT CondensingMemory : public ConicMemory {
+    // Memory object of the condensed QP solver
+    int qp_mem;
+  };
+
+  /** \brief \pluginbrief{Conic,condensing}
+
+      @copydoc Conic_doc
+      @copydoc plugin_Conic_condensing
+  */
+  class CASADI_CONIC_CONDENSING_EXPORT Condensing : public Conic {
+  public:
+    /** \brief  Create a new Solver */
+    explicit Condensing(const std::string& name,
+                        const std::map<std::string, Sparsity> &st);
+
+    /** \brief  Create a new QP Solver */
+    static Conic* creator(const std::string& name,
+                          const std::map<std::string, Sparsity>& st) {
+      return new Condensing(name, st);
+    }
+
+    /** \brief  Destructor */
+    ~Condensing() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "condensing";}
+
+    // Get name of the class
+    std::string class_name() const override { return "Condensing";}
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override;
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    int solve(const double** arg, double** res,
+      casadi_int* iw, double* w, void* mem) const override;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    /// Solver for the condensed QP
+    Function solver_;
+
+    /// Map from the QP data to the condensed QP data
+    Function condense_;
+
+    /// Map from the condensed QP solution to the full one
+    Function expand_;
+
+    /// Dynamics rows that are eliminated
+    std::vector<casadi_int> elim_rows_;
+
+    void serialize_body(SerializingStream &s) const override;
+
+    /** \brief Deserialize with type disambiguation */
+    static ProtoFunction* deserialize(DeserializingStream& s) { return new Condensing(s); }
+
+  protected:
+     /** \brief Deserializing constructor */
+    explicit Condensing(DeserializingStream& s);
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_CONDENSING_HPP
@@ -0,0 +1,48 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "condensing.hpp"
+      #include <string>
+
+      const std::string casadi::Condensing::meta_doc=
+      "\n"
+"\n"
+"\n"
+"Condensing preprocessor for QPs with optimal control structure\n"
+"\n"
+"The decision variables are ordered as x0, u0, x1, u1, ..., xN, uN and the\n"
+"constraints as the dynamics of stage 0, the path constraints of stage 0,\n"
+"..., the path constraints of stage N, using the same layout as the 'hpipm'\n"
+"plugin (options 'N', 'nx', 'nu', 'ng').\n"
+"\n"
+"States are eliminated using the dynamics, which must be equality\n"
+"constraints that are explicit in the next state. The condensed, smaller\n"
+"and denser QP is solved with the Conic plugin given by the 'conic' option\n"
+"and the solution is expanded afterwards. With 'block_size' > 0, only the\n"
+"states inside blocks of that many stages are eliminated (partial\n"
+"condensing). Bounds on eliminated states become linear constraints.\n"
+"\n"
+;
@@ -0,0 +1,355 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "multistart.hpp"
+
+#include "casadi/core/casadi_misc.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+#ifdef CASADI_WITH_THREAD
+#include <atomic>
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.thread.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <thread>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
+namespace casadi {
+
+  extern "C"
+  int CASADI_NLPSOL_MULTISTART_EXPORT
+      casadi_register_nlpsol_multistart(Nlpsol::Plugin* plugin) {
+    plugin->creator = Multistart::creator;
+    plugin->name = "multistart";
+    plugin->doc = Multistart::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &Multistart::options_;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_NLPSOL_MULTISTART_EXPORT casadi_load_nlpsol_multistart() {
+    Nlpsol::registerPlugin(casadi_register_nlpsol_multistart);
+  }
+
+  Multistart::Multistart(const std::string& name, const Function& nlp)
+    : Nlpsol(name, nlp) {
+  }
+
+  Multistart::~Multistart() {
+    clear_mem();
+  }
+
+  const Options Multistart::options_
+  = {{&Nlpsol::options_},
+     {{"nlpsol",
+       {OT_STRING,
+        "The NLP solver plugin used for each start"}},
+      {"nlpsol_options",
+       {OT_DICT,
+        "Options to be passed to the NLP solver"}},
+      {"n_starts",
+       {OT_INT,
+        "Total number of starts, including x0 and the user-provided starts [10]"}},
+      {"starts",
+       {OT_DOUBLEVECTORVECTOR,
+        "Additional initial guesses, tried after x0 and before the sampled ones"}},
+      {"seed",
+       {OT_INT,
+        "Seed of the random number generator used for sampling [0]"}},
+      {"num_threads",
+       {OT_INT,
+        "Number of starts solved concurrently. Requires CasADi to be compiled "
+        "with WITH_THREAD=ON [1]"}},
+      {"unbounded_range",
+       {OT_DOUBLE,
+        "Variables with an infinite bound are sampled at most this far away "
+        "from x0 [1]"}},
+      {"objective_target",
+       {OT_DOUBLE,
+        "Stop launching new starts once a successful run reaches an objective "
+        "value at or below this target [-inf]"}}
+     }
+  };
+
+  void Multistart::init(const Dict& opts) {
+    // Call the init method of the base class
+    Nlpsol::init(opts);
+
+    // Default options
+    std::string nlpsol_plugin;
+    Dict nlpsol_options;
+    n_starts_ = 10;
+    seed_ = 0;
+    num_threads_ = 1;
+    unbounded_range_ = 1;
+    objective_target_ = -inf;
+
+    // Read user options
+    for (auto&& op : opts) {
+      if (op.first=="nlpsol") {
+        nlpsol_plugin = op.second.to_string();
+      } else if (op.first=="nlpsol_options") {
+        nlpsol_options = op.second;
+      } else if (op.first=="n_starts") {
+        n_starts_ = op.second;
+      } else if (op.first=="starts") {
+        starts_ = op.second;
+      } else if (op.first=="seed") {
+        seed_ = op.second;
+      } else if (op.first=="num_threads") {
+        num_threads_ = op.second;
+      } else if (op.first=="unbounded_range") {
+        unbounded_range_ = op.second;
+      } else if (op.first=="objective_target") {
+        objective_target_ = op.second;
+      }
+    }
+
+    // Consistency checks
+    casadi_assert(!nlpsol_plugin.empty(), "Option 'nlpsol' must be set");
+    casadi_assert(nlpsol_plugin!="multistart", "Nested multistart is not supported");
+    casadi_assert(detect_simple_bounds_is_simple_.empty(),
+      "Option 'detect_simple_bounds' is not supported, pass it to the inner "
+      "solver with 'nlpsol_options' instead");
+    casadi_assert(unbounded_range_>0, "Option 'unbounded_range' must be positive");
+    casadi_assert(num_threads_>=1, "Option 'num_threads' must be at least 1");
+    for (auto&& s : starts_) {
+      casadi_assert(s.size()==nx_, "Each entry of 'starts' must have length " + str(nx_)
+        + ", but got " + str(s.size()));
+    }
+    n_starts_ = std::max(n_starts_, casadi_int(1 + starts_.size()));
+
+#ifndef CASADI_WITH_THREAD
+    if (num_threads_>1) {
+      casadi_warning("CasADi was not compiled with WITH_THREAD=ON. "
+                     "Falling back to serial evaluation.");
+      num_threads_ = 1;
+    }
+#endif // CASADI_WITH_THREAD
+    num_threads_ = std::min(num_threads_, n_starts_);
+
+    // Create the inner solver
+    solver_ = nlpsol(name_ + "_solver", nlpsol_plugin, oracle_, nlpsol_options);
+  }
+
+  int Multistart::init_mem(void* mem) const {
+    if (Nlpsol::init_mem(mem)) return 1;
+    auto m = static_cast<MultistartMemory*>(mem);
+    m->x0.resize(nx_ * n_starts_);
+    m->x.resize(nx_ * n_starts_);
+    m->g.resize(ng_ * n_starts_);
+    m->lam_x.resize(nx_ * n_starts_);
+    m->lam_g.resize(ng_ * n_starts_);
+    m->lam_p.resize(np_ * n_starts_);
+    m->f.resize(n_starts_);
+    m->flag.resize(n_starts_);
+    m->start_success.resize(n_starts_);
+    m->start_stats.resize(n_starts_);
+    m->ranking.resize(n_starts_);
+    m->n_solved = 0;
+    return 0;
+  }
+
+  void Multistart::sample_starts(MultistartMemory* m) const {
+    auto d_nlp = &m->d_nlp;
+
+    // Start 0 is x0, followed by the user-provided starts
+    casadi_copy(d_nlp->z, nx_, get_ptr(m->x0));
+    for (casadi_int k=0; k<starts_.size(); ++k) {
+      casadi_copy(get_ptr(starts_[k]), nx_, get_ptr(m->x0) + (k+1)*nx_);
+    }
+
+    // Latin hypercube sampling for the remaining starts
+    casadi_int k0 = 1 + starts_.size(), n = n_starts_ - k0;
+    if (n==0) return;
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(seed_));
+    std::uniform_real_distribution<double> unif(0., 1.);
+    std::vector<casadi_int> strata(n);
+    for (casadi_int i=0; i<nx_; ++i) {
+      // Sampling interval
+      double lb = d_nlp->lbz[i], ub = d_nlp->ubz[i], x0 = d_nlp->z[i];
+      if (std::isinf(lb)) lb = std::isinf(ub) ? x0 - unbounded_range_ : ub - 2*unbounded_range_;
+      if (std::isinf(ub)) ub = lb + 2*unbounded_range_;
+      // One sample per stratum, randomly permuted
+      std::iota(strata.begin(), strata.end(), 0);
+      std::shuffle(strata.begin(), strata.end(), rng);
+      for (casadi_int k=0; k<n; ++k) {
+        double t = (static_cast<double>(strata[k]) + unif(rng)) / static_cast<double>(n);
+        m->x0[(k0+k)*nx_ + i] = lb + t*(ub - lb);
+      }
+    }
+  }
+
+  void Multistart::solve_start(MultistartMemory* m, casadi_int k) const {
+    auto d_nlp = &m->d_nlp;
+
+    // Work vectors for the inner solver
+    std::vector<const double*> arg(solver_.sz_arg(), nullptr);
+    std::vector<double*> res(solver_.sz_res(), nullptr);
+    std::vector<casadi_int> iw(solver_.sz_iw());
+    std::vector<double> w(solver_.sz_w());
+
+    // Inputs
+    arg[NLPSOL_X0] = get_ptr(m->x0) + k*nx_;
+    arg[NLPSOL_P] = d_nlp->p;
+    arg[NLPSOL_LBX] = d_nlp->lbz;
+    arg[NLPSOL_UBX] = d_nlp->ubz;
+    arg[NLPSOL_LBG] = d_nlp->lbz + nx_;
+    arg[NLPSOL_UBG] = d_nlp->ubz + nx_;
+    arg[NLPSOL_LAM_X0] = d_nlp->lam;
+    arg[NLPSOL_LAM_G0] = d_nlp->lam + nx_;
+
+    // Outputs
+    res[NLPSOL_X] = get_ptr(m->x) + k*nx_;
+    res[NLPSOL_F] = get_ptr(m->f) + k;
+    res[NLPSOL_G] = get_ptr(m->g) + k*ng_;
+    res[NLPSOL_LAM_X] = get_ptr(m->lam_x) + k*nx_;
+    res[NLPSOL_LAM_G] = get_ptr(m->lam_g) + k*ng_;
+    res[NLPSOL_LAM_P] = get_ptr(m->lam_p) + k*np_;
+
+    // Solve with a private memory object of the inner solver
+    int mem = solver_.checkout();
+    try {
+      m->flag[k] = solver_(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), mem);
+      m->start_stats[k] = solver_.stats(mem);
+    } catch (std::exception& e) {
+      m->flag[k] = 1;
+      m->start_stats[k] = Dict{{"success", false}, {"return_status", std::string(e.what())}};
+    }
+    solver_.release(mem);
+    auto it = m->start_stats[k].find("success");
+    m->start_success[k] = !m->flag[k] && it!=m->start_stats[k].end() && it->second.to_bool();
+  }
+
+  int Multistart::solve(void* mem) const {
+    auto m = static_cast<MultistartMemory*>(mem);
+    auto d_nlp = &m->d_nlp;
+
+    // Generate initial guesses
+    sample_starts(m);
+    std::fill(m->f.begin(), m->f.end(), nan);
+    std::fill(m->flag.begin(), m->flag.end(), 0);
+    std::fill(m->start_success.begin(), m->start_success.end(), false);
+    std::fill(m->start_stats.begin(), m->start_stats.end(), Dict());
+
+    // Has a start reached the objective target?
+    auto target_reached = [&](casadi_int k) {
+      return m->start_success[k] && m->f[k] <= objective_target_;
+    };
+
+#ifdef CASADI_WITH_THREAD
+    if (num_threads_>1) {
+      // Each worker pulls the next start until all are done or the target is reached
+      std::atomic<casadi_int> next(0), n_solved(0);
+      std::atomic<bool> done(false);
+      auto worker = [&]() {
+        while (!done) {
+          casadi_int k = next++;
+          if (k>=n_starts_) break;
+          solve_start(m, k);
+          n_solved++;
+          if (target_reached(k)) done = true;
+        }
+      };
+      std::vector<std::thread> threads;
+      for (casadi_int i=0; i<num_threads_; ++i) threads.emplace_back(worker);
+      for (auto&& th : threads) th.join();
+      m->n_solved = n_solved;
+    } else {
+#endif // CASADI_WITH_THREAD
+      m->n_solved = 0;
+      for (casadi_int k=0; k<n_starts_; ++k) {
+        solve_start(m, k);
+        m->n_solved++;
+        if (target_reached(k)) break;
+      }
+#ifdef CASADI_WITH_THREAD
+    }
+#endif // CASADI_WITH_THREAD
+
+    // Rank the starts: successful runs first, then by objective value
+    std::iota(m->ranking.begin(), m->ranking.end(), 0);
+    std::stable_sort(m->ranking.begin(), m->ranking.end(),
+      [&](casadi_int a, casadi_int b) {
+        bool a_run = !m->start_stats[a].empty(), b_run = !m->start_stats[b].empty();
+        if (a_run!=b_run) return a_run;
+        if (m->start_success[a]!=m->start_success[b]) return bool(m->start_success[a]);
+        if (std::isnan(m->f[b])) return !std::isnan(m->f[a]);
+        return m->f[a] < m->f[b];
+      });
+
+    // Pass on the best solution
+    casadi_int best = m->ranking.front();
+    if (verbose_) {
+      casadi_message("Best of " + str(m->n_solved) + " starts is start " + str(best)
+        + " with f = " + str(m->f[best]));
+    }
+    casadi_copy(get_ptr(m->x) + best*nx_, nx_, d_nlp->z);
+    casadi_copy(get_ptr(m->g) + best*ng_, ng_, d_nlp->z + nx_);
+    casadi_copy(get_ptr(m->lam_x) + best*nx_, nx_, d_nlp->lam);
+    casadi_copy(get_ptr(m->lam_g) + best*ng_, ng_, d_nlp->lam + nx_);
+    casadi_copy(get_ptr(m->lam_p) + best*np_, np_, d_nlp->lam_p);
+    d_nlp->objective = m->f[best];
+    m->success = m->start_success[best];
+    m->unified_return_status = m->success ? SOLVER_RET_SUCCESS : SOLVER_RET_UNKNOWN;
+    return 0;
+  }
+
+  Dict Multistart::get_stats(void* mem) const {
+    Dict stats = Nlpsol::get_stats(mem);
+    auto m = static_cast<MultistartMemory*>(mem);
+    std::vector<Dict> starts;
+    std::vector<casadi_int> ranking;
+    for (casadi_int k : m->ranking) {
+      if (m->start_stats[k].empty()) continue;
+      ranking.push_back(k);
+    }
+    for (casadi_int k=0; k<n_starts_; ++k) {
+      if (m->start_stats[k].empty()) continue;
+      Dict s = m->start_stats[k];
+      s["start"] = k;
+      s["f"] = m->f[k];
+      s["success"] = bool(m->start_success[k]);
+      starts.push_back(s);
+    }
+    stats["starts"] = starts;
+    stats["ranking"] = ranking;
+    stats["n_starts"] = m->n_solved;
+    if (!ranking.empty()) {
+      stats["best_start"] = ranking.front();
+      auto it = m->start_stats[ranking.front()].find("return_status");
+      if (it!=m->start_stats[ranking.front()].end()) stats["return_status"] = it->second;
+    }
+    return stats;
+  }
+
+} // namespace casadi
@@ -0,0 +1,147 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_MULTISTART_HPP
+#define CASADI_MULTISTART_HPP
+
+#include "casadi/core/nlpsol_impl.hpp"
+#include <casadi/solvers/casadi_nlpsol_multistart_export.h>
+
+/** \defgroup plugin_Nlpsol_multistart Title
+    \par
+
+ Multi-start driver around another NLP solver plugin.
+
+ The NLP is solved from a number of initial guesses, possibly in parallel.
+ The first start is the user-provided x0, followed by any starts passed with
+ the 'starts' option. The remaining starts are drawn by Latin hypercube
+ sampling within the variable bounds. The best solution, successful runs
+ ranked before failed ones and then by objective value, is returned. */
+
+/** \pluginsection{Nlpsol,multistart} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  struct CASADI_NLPSOL_MULTISTART_EXPORT MultistartMemory : public NlpsolMemory {
+    /// Initial guesses, one column per start
+    std::vector<double> x0;
+
+    /// Results, one column per start
+    std::vector<double> x, g, lam_x, lam_g, lam_p, f;
+
+    /// Return flags and success per start, not packed: written concurrently by the workers
+    std::vector<int> flag;
+    std::vector<char> start_success;
+
+    /// Statistics of the inner solver per start (empty if not run)
+    std::vector<Dict> start_stats;
+
+    /// Starts sorted from best to worst
+    std::vector<casadi_int> ranking;
+
+    /// Number of starts that were solved
+    casadi_int n_solved;
+  };
+
+  /** \brief  \pluginbrief{Nlpsol,multistart}
+  *  @copydoc NLPSolver_doc
+  *  @copydoc plugin_Nlpsol_multistart
+  */
+  class CASADI_NLPSOL_MULTISTART_EXPORT Multistart : public Nlpsol {
+  public:
+    explicit Multistart(const std::string& name, const Function& nlp);
+    ~Multistart() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "multistart";}
+
+    // Name of the class
+    std::string class_name() const override { return "Multistart";}
+
+    /** \brief  Create a new NLP Solver */
+    static Nlpsol* creator(const std::string& name, const Function& nlp) {
+      return new Multistart(name, nlp);
+    }
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    // Initialize the solver
+    void init(const Dict& opts) override;
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new MultistartMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<MultistartMemory*>(mem);}
+
+    // Solve the NLP
+    int solve(void* mem) const override;
+
+    /// Generate the initial guesses
+    void sample_starts(MultistartMemory* m) const;
+
+    /// Solve the NLP from start k using the inner solver
+    void solve_start(MultistartMemory* m, casadi_int k) const;
+
+    /// Inner NLP solver
+    Function solver_;
+
+    /// Total number of starts
+    casadi_int n_starts_;
+
+    /// User-provided initial guesses (excluding x0)
+    std::vector<std::vector<double> > starts_;
+
+    /// Seed of the random number generator
+    casadi_int seed_;
+
+    /// Number of starts solved concurrently
+    casadi_int num_threads_;
+
+    /// Half-width of the sampling range for variables without finite bounds
+    double unbounded_range_;
+
+    /// Stop launching new starts once a successful run reaches this objective
+    double objective_target_;
+
+    /// A documentation string
+    static const std::string meta_doc;
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_MULTISTART_HPP
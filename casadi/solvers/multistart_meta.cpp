@@ -0,0 +1,42 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "multistart.hpp"
+      #include <string>
+
+      const std::string casadi::Multistart::meta_doc=
+      "\n"
+"\n"
+"Multi-start driver around another NLP solver plugin.\n"
+"\n"
+"The NLP is solved from a number of initial guesses, possibly in parallel.\n"
+"The first start is the user-provided x0, followed by any starts passed\n"
+"with the 'starts' option. The remaining starts are drawn by Latin\n"
+"hypercube sampling within the variable bounds. The best solution,\n"
+"successful runs ranked before failed ones and then by objective value, is\n"
+"returned.\n"
+"\n"
+;
@@ -36,6 +36,14 @@
 
 #include <cstdlib>
 
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.thread.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <thread>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
 namespace casadi {
 
   extern "C"
@@ -65,6 +73,10 @@ namespace casadi {
     if (cleanup_) {
       if (remove(bin_name_.c_str())) casadi_warning("Failed to remove " + bin_name_);
       if (remove(obj_name_.c_str())) casadi_warning("Failed to remove " + obj_name_);
+      for (const std::string& s : extra_obj_names_) {
+        if (incremental_) break;
+        if (remove(s.c_str())) casadi_warning("Failed to remove " + s);
+      }
       for (const std::string& s : extra_suffixes_) {
         std::string name = base_name_+s;
         remove(name.c_str());
@@ -114,6 +126,21 @@ namespace casadi {
       {"extra_suffixes",
        {OT_STRINGVECTOR,
        "List of suffixes for extra files that the compiler may generate. Default: None"}},
+      {"extra_sources",
+       {OT_STRINGVECTOR,
+       "Additional source files to be compiled and linked into the same library, "
+       "e.g. from code generation with the 'split' option. Default: None"}},
+      {"incremental",
+       {OT_BOOL,
+       "Name the objects of the additional sources after the source, its content and "
+       "the compiler command, keep them, and reuse existing ones instead of recompiling. "
+       "Objects no longer used by the same source file are removed. "
+       "Use with sources from code generation with the 'incremental' option. "
+       "Default: false"}},
+      {"max_num_threads",
+       {OT_INT,
+       "Maximum number of source files compiled in parallel. "
+       "Default: number of hardware threads"}},
       {"name",
        {OT_STRING,
         "The file name used to write out compiled objects/libraries. "
@@ -135,12 +162,17 @@ namespace casadi {
     // Default options
 
     cleanup_ = true;
+    incremental_ = false;
     bool temp_suffix = true;
     std::string bare_name = "tmp_casadi_compiler_shell";
     std::string directory = "";
 
     std::vector<std::string> compiler_flags;
     std::vector<std::string> linker_flags;
+    std::vector<std::string> extra_sources;
+#ifdef CASADI_WITH_THREAD
+    casadi_int max_num_threads = 0;
+#endif // CASADI_WITH_THREAD
     std::string suffix = OBJECT_FILE_SUFFIX;
 
 #ifdef _WIN32
@@ -184,6 +216,14 @@ namespace casadi {
         linker_output_flag = op.second.to_string();
       } else if (op.first=="extra_suffixes") {
         extra_suffixes_ = op.second.to_string_vector();
+      } else if (op.first=="extra_sources") {
+        extra_sources = op.second.to_string_vector();
+      } else if (op.first=="incremental") {
+        incremental_ = op.second;
+      } else if (op.first=="max_num_threads") {
+#ifdef CASADI_WITH_THREAD
+        max_num_threads = op.second;
+#endif // CASADI_WITH_THREAD
       } else if (op.first=="name") {
         bare_name = op.second.to_string();
       } else if (op.first=="temp_suffix") {
@@ -211,32 +251,96 @@ namespace casadi {
     }
 #endif // _WIN32
 
-    // Construct the compiler command
-    std::stringstream cccmd;
-    cccmd << compiler;
+    // Compiler with flags
+    std::stringstream ccbase;
+    ccbase << compiler;
     for (auto i=compiler_flags.begin(); i!=compiler_flags.end(); ++i) {
-      cccmd << " " << *i;
+      ccbase << " " << *i;
+    }
+    ccbase << " " << compiler_setup;
+
+    // Object files for the additional sources
+    for (casadi_int i=0; i<extra_sources.size(); ++i) {
+      if (incremental_) {
+        // Persistent, named after the source, its content and the compiler command
+        const std::string& src = extra_sources[i];
+        std::ifstream in(src);
+        std::stringstream content;
+        content << ccbase.str() << "\n" << in.rdbuf();
+        extra_obj_names_.push_back(src.substr(0, src.rfind('.')) + "_"
+          + hash_hex(content.str()) + suffix);
+      } else {
+        extra_obj_names_.push_back(obj_name_.substr(0, obj_name_.size()-suffix.size())
+          + "_" + str(i+1) + suffix);
+      }
     }
-    cccmd << " " << compiler_setup;
 
-    // C/C++ source file
-    cccmd << " " << name_;
+    // Remove the objects of a previous compilation that are no longer used
+    if (incremental_) {
+      std::string manifest = name_.substr(0, name_.rfind('.')) + ".objects";
+      std::ifstream in(manifest);
+      for (std::string s; std::getline(in, s); ) {
+        if (std::find(extra_obj_names_.begin(), extra_obj_names_.end(), s)
+            ==extra_obj_names_.end()) remove(s.c_str());
+      }
+      in.close();
+      std::ofstream out(manifest);
+      for (const std::string& s : extra_obj_names_) out << s << "\n";
+    }
 
-    // Temporary object file
-    cccmd << " " + compiler_output_flag << obj_name_;
+    // Construct the compiler commands
+    std::vector<std::string> sources = {name_}, objects = {obj_name_}, cccmds, ccobjs;
+    sources.insert(sources.end(), extra_sources.begin(), extra_sources.end());
+    objects.insert(objects.end(), extra_obj_names_.begin(), extra_obj_names_.end());
+    for (casadi_int k=0; k<sources.size(); ++k) {
+      // Objects already compiled
+      if (incremental_ && k>0 && std::ifstream(objects[k]).good()) continue;
+      std::stringstream cccmd;
+      cccmd << ccbase.str();
+
+      // C/C++ source file
+      cccmd << " " << sources[k];
+
+      // Temporary object file
+      cccmd << " " + compiler_output_flag << objects[k];
+      cccmds.push_back(cccmd.str());
+      ccobjs.push_back(objects[k]);
+    }
 
-    // Compile into an object
-    if (verbose_) casadi_message("calling \"" + cccmd.str() + "\"");
-    if (system(cccmd.str().c_str())) {
-      casadi_error("Compilation failed. Tried \"" + cccmd.str() + "\"");
+    // Compile into objects
+    std::vector<int> flags(cccmds.size());
+    auto compile = [&](casadi_int i) {
+      if (verbose_) casadi_message("calling \"" + cccmds[i] + "\"");
+      flags[i] = system(cccmds[i].c_str());
+    };
+#ifdef CASADI_WITH_THREAD
+    if (max_num_threads<=0) max_num_threads = std::thread::hardware_concurrency();
+    if (max_num_threads<=0) max_num_threads = 1;
+    for (casadi_int i0=0; i0<cccmds.size(); i0+=max_num_threads) {
+      std::vector<std::thread> threads;
+      casadi_int i1 = std::min(i0+max_num_threads, static_cast<casadi_int>(cccmds.size()));
+      for (casadi_int i=i0; i<i1; ++i) threads.emplace_back(compile, i);
+      for (auto&& th : threads) th.join();
+    }
+#else // CASADI_WITH_THREAD
+    for (casadi_int i=0; i<cccmds.size(); ++i) compile(i);
+#endif // CASADI_WITH_THREAD
+    for (casadi_int i=0; i<cccmds.size(); ++i) {
+      if (flags[i]) {
+        // A partially written object must not be reused
+        if (incremental_) remove(ccobjs[i].c_str());
+        casadi_error("Compilation failed. Tried \"" + cccmds[i] + "\"");
+      }
     }
 
     // Link step
     std::stringstream ldcmd;
     ldcmd << linker;
 
-    // Temporary file
-    ldcmd << " " << obj_name_ << " " + linker_output_flag + bin_name_;
+    // Temporary files
+    ldcmd << " " << obj_name_;
+    for (const std::string& s : extra_obj_names_) ldcmd << " " << s;
+    ldcmd << " " + linker_output_flag + bin_name_;
 
     // Add flags
     for (auto i=linker_flags.begin(); i!=linker_flags.end(); ++i) {
@@ -97,12 +97,18 @@ namespace casadi {
     /// Temporary file
     std::string obj_name_;
 
+    /// Temporary files for additional sources
+    std::vector<std::string> extra_obj_names_;
+
     /// Extra files
     std::vector<std::string> extra_suffixes_;
 
     /// Cleanup temporary files when unloading
     bool cleanup_;
 
+    /// Keep and reuse the objects of the additional sources
+    bool incremental_;
+
     // Shared library handle
     handle_t handle_;
   };
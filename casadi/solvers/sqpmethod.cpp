@@ -57,6 +57,7 @@ void CASADI_NLPSOL_SQPMETHOD_EXPORT casadi_load_nlpsol_sqpmethod() {
 
 Sqpmethod::Sqpmethod(const std::string& name, const Function& nlp)
   : Nlpsol(name, nlp) {
+  rti_ = false;
 }
 
 Sqpmethod::~Sqpmethod() {
@@ -83,6 +84,11 @@ const Options Sqpmethod::options_
     {"max_iter_ls",
       {OT_INT,
       "Maximum number of linesearch iterations"}},
+    {"ls_batch",
+      {OT_INT,
+      "Number of step lengths evaluated concurrently in each round of the line-search, "
+      "using a thread-parallel map of nlp_fg. The largest accepted step length is taken "
+      "(default: 1, sequential backtracking)."}},
     {"tol_pr",
       {OT_DOUBLE,
       "Stopping criterion for primal infeasibility"}},
@@ -101,6 +107,20 @@ const Options Sqpmethod::options_
     {"lbfgs_memory",
       {OT_INT,
       "Size of L-BFGS memory."}},
+    {"rti",
+      {OT_BOOL,
+      "Real-time iteration mode: each call performs at most a single full SQP step, "
+      "split into a preparation phase (evaluate derivatives at x0, lam_x0, lam_g0 and p) "
+      "and a feedback phase (solve the prepared QP with the bounds of the call). "
+      "The solver gets an additional input 'rti_phase': 0 performs both phases, "
+      "1 only prepares and returns the linearization point, 2 only solves the QP "
+      "prepared by an earlier call. Supported in code generation, where the "
+      "prepared QP is stored per memory object. Sensitivities are not available [false]"}},
+    {"partitioned_bfgs",
+      {OT_BOOL,
+      "With a quasi-Newton Hessian, detect the block-diagonal structure of the "
+      "Lagrangian Hessian and perform independent BFGS updates for each block, "
+      "rather than a dense update [false]"}},
     {"print_header",
       {OT_BOOL,
       "Print the header with problem statistics"}},
@@ -155,6 +175,10 @@ const Options Sqpmethod::options_
 };
 
 void Sqpmethod::init(const Dict& opts) {
+  // Real-time iteration mode changes the number of inputs, needed by the base class
+  auto rti_it = opts.find("rti");
+  if (rti_it!=opts.end()) rti_ = rti_it->second;
+
   // Call the init method of the base class
   Nlpsol::init(opts);
 
@@ -162,10 +186,13 @@ void Sqpmethod::init(const Dict& opts) {
   min_iter_ = 0;
   max_iter_ = 50;
   max_iter_ls_ = 3;
+  ls_batch_ = 1;
   c1_ = 1e-4;
   beta_ = 0.8;
   merit_memsize_ = 4;
   lbfgs_memory_ = 10;
+  bool partitioned_bfgs = false;
+  n_hess_blk_ = 0;
   tol_pr_ = 1e-6;
   tol_du_ = 1e-6;
   std::string hessian_approximation = "exact";
@@ -194,6 +221,8 @@ void Sqpmethod::init(const Dict& opts) {
       min_iter_ = op.second;
     } else if (op.first=="max_iter_ls") {
       max_iter_ls_ = op.second;
+    } else if (op.first=="ls_batch") {
+      ls_batch_ = op.second;
     } else if (op.first=="c1") {
       c1_ = op.second;
     } else if (op.first=="beta") {
@@ -202,6 +231,8 @@ void Sqpmethod::init(const Dict& opts) {
       merit_memsize_ = op.second;
     } else if (op.first=="lbfgs_memory") {
       lbfgs_memory_ = op.second;
+    } else if (op.first=="partitioned_bfgs") {
+      partitioned_bfgs = op.second;
     } else if (op.first=="tol_pr") {
       tol_pr_ = op.second;
     } else if (op.first=="tol_du") {
@@ -268,6 +299,17 @@ void Sqpmethod::init(const Dict& opts) {
 
   // Get/generate required functions
   if (max_iter_ls_ || so_corr_) create_function("nlp_fg", {"x", "p"}, {"f", "g"});
+
+  // Candidate step lengths of the line-search evaluated in parallel
+  casadi_assert(ls_batch_>=1, "Option 'ls_batch' must be positive");
+  if (max_iter_ls_ && ls_batch_>1) {
+#ifndef CASADI_WITH_THREAD
+    casadi_warning("Option 'ls_batch' evaluates candidates serially: "
+                   "CasADi was compiled without thread support.");
+#endif // CASADI_WITH_THREAD
+    set_function(get_function("nlp_fg").map("nlp_fg_batch", "thread", ls_batch_, {"p"},
+      std::vector<std::string>()), "nlp_fg_batch");
+  }
   // First order derivative information
 
   if (!has_function("nlp_jac_fg")) {
@@ -292,6 +334,28 @@ void Sqpmethod::init(const Dict& opts) {
       opts["verbose"] = verbose_;
       Hsp_ = Convexify::setup(convexify_data_, Hsp_, opts);
     }
+  } else if (partitioned_bfgs) {
+    // Structural sparsity of the Lagrangian Hessian from the gradient of the Lagrangian
+    Function grad_l = oracle_.factory("nlp_grad_l", {"x", "p", "lam:f", "lam:g"},
+      {"grad:gamma:x"}, {{"gamma", {"f", "g"}}});
+    Sparsity sp = grad_l.jac_sparsity(0, 0) + Sparsity::diag(nx_);
+    // Connected components
+    std::vector<casadi_int> index, offset;
+    n_hess_blk_ = sp.scc(index, offset);
+    hess_blk_.resize(nx_);
+    for (casadi_int b = 0; b < n_hess_blk_; ++b) {
+      for (casadi_int k = offset[b]; k < offset[b + 1]; ++k) hess_blk_[index[k]] = b;
+    }
+    // Dense diagonal blocks
+    std::vector<casadi_int> colind(1, 0), row;
+    for (casadi_int c = 0; c < nx_; ++c) {
+      casadi_int b = hess_blk_[c];
+      std::vector<casadi_int> r(index.begin() + offset[b], index.begin() + offset[b + 1]);
+      std::sort(r.begin(), r.end());
+      row.insert(row.end(), r.begin(), r.end());
+      colind.push_back(row.size());
+    }
+    Hsp_ = Sparsity(nx_, nx_, colind, row);
   } else {
     Hsp_ = Sparsity::dense(nx_, nx_);
   }
@@ -325,7 +389,7 @@ void Sqpmethod::init(const Dict& opts) {
 
   // BFGS?
   if (!exact_hessian_) {
-    alloc_w(2*nx_); // casadi_bfgs
+    alloc_w(2*nx_ + 2*hess_blk_.size()); // casadi_bfgs, casadi_bfgs_block
   }
 
   // Header
@@ -334,6 +398,8 @@ void Sqpmethod::init(const Dict& opts) {
     print("This is casadi::Sqpmethod.\n");
     if (exact_hessian_) {
       print("Using exact Hessian\n");
+    } else if (!hess_blk_.empty()) {
+      print("Using partitioned BFGS Hessian approximation (%d blocks)\n", n_hess_blk_);
     } else {
       print("Using limited memory BFGS Hessian approximation\n");
     }
@@ -369,6 +435,12 @@ void Sqpmethod::set_work(void* mem, const double**& arg, double**& res,
                               casadi_int*& iw, double*& w) const {
   auto m = static_cast<SqpmethodMemory*>(mem);
 
+  // Real-time iteration phase, before the base class uses the extra input as work
+  if (rti_) {
+    const double* phase = arg[NLPSOL_NUM_IN];
+    m->rti_phase = phase ? static_cast<casadi_int>(*phase) : 0;
+  }
+
   // Set work in base classes
   Nlpsol::set_work(mem, arg, res, iw, w);
 
@@ -387,6 +459,23 @@ int Sqpmethod::init_mem(void* mem) const {
   m->add_stat("QP");
   m->add_stat("linesearch");
   m->mem_qp = qpsol_->checkout();
+
+  // Batched line-search
+  if (has_function("nlp_fg_batch")) {
+    m->ls_x.resize(nx_ * ls_batch_);
+    m->ls_f.resize(ls_batch_);
+    m->ls_g.resize(ng_ * ls_batch_);
+  }
+
+  // Real-time iteration
+  m->rti_iter = 0;
+  if (rti_) {
+    m->rti_z.resize(nx_ + ng_);
+    m->rti_lam.resize(nx_ + ng_);
+    m->rti_gf.resize(nx_);
+    m->rti_jk.resize(Asp_.nnz());
+    m->rti_bk.resize(Hsp_.nnz());
+  }
   return 0;
 }
 
@@ -396,11 +485,164 @@ void Sqpmethod::free_mem(void* mem) const {
   delete static_cast<SqpmethodMemory*>(mem);
 }
 
+Sparsity Sqpmethod::get_sparsity_in(casadi_int i) {
+  if (i==NLPSOL_NUM_IN) return Sparsity::scalar();
+  return Nlpsol::get_sparsity_in(i);
+}
+
+std::string Sqpmethod::get_name_in(casadi_int i) {
+  if (i==NLPSOL_NUM_IN) return "rti_phase";
+  return Nlpsol::get_name_in(i);
+}
+
+double Sqpmethod::get_default_in(casadi_int ind) const {
+  if (ind==NLPSOL_NUM_IN) return 0;
+  return Nlpsol::get_default_in(ind);
+}
+
+int Sqpmethod::rti_prepare(SqpmethodMemory* m) const {
+  auto d_nlp = &m->d_nlp;
+  auto d = &m->d;
+  const double one = 1.;
+
+  if (!exact_hessian_ && m->rti_iter > 0) {
+    // Step and gradient of the Lagrangian at the previous point with the new multipliers
+    casadi_copy(d_nlp->z, nx_, d->dx);
+    casadi_axpy(nx_, -1., get_ptr(m->rti_z), d->dx);
+    casadi_copy(get_ptr(m->rti_gf), nx_, d->gLag_old);
+    casadi_mv(get_ptr(m->rti_jk), Asp_, d_nlp->lam + nx_, d->gLag_old, true);
+    casadi_axpy(nx_, 1., d_nlp->lam, d->gLag_old);
+  }
+
+  // Evaluate f, g and first order derivative information
+  m->arg[0] = d_nlp->z;
+  m->arg[1] = d_nlp->p;
+  m->res[0] = &d_nlp->objective;
+  m->res[1] = d->gf;
+  m->res[2] = d_nlp->z + nx_;
+  m->res[3] = d->Jk;
+  switch (calc_function(m, "nlp_jac_fg")) {
+    case -1:
+      m->return_status = "Non_Regular_Sensitivities";
+      m->unified_return_status = SOLVER_RET_NAN;
+      return 1;
+    case 0:
+      break;
+    default:
+      return 1;
+  }
+
+  if (exact_hessian_) {
+    // Exact Hessian
+    m->arg[0] = d_nlp->z;
+    m->arg[1] = d_nlp->p;
+    m->arg[2] = &one;
+    m->arg[3] = d_nlp->lam + nx_;
+    m->res[0] = d->Bk;
+    if (calc_function(m, "nlp_hess_l")) return 1;
+    if (convexify_) {
+      ScopedTiming tic(m->fstats.at("convexify"));
+      if (convexify_eval(&convexify_data_.config, d->Bk, d->Bk, m->iw, m->w)) return 1;
+    }
+  } else if (m->rti_iter == 0) {
+    ScopedTiming tic(m->fstats.at("BFGS"));
+    // Initialize BFGS
+    casadi_fill(d->Bk, Hsp_.nnz(), 1.);
+    casadi_bfgs_reset(Hsp_, d->Bk);
+  } else {
+    ScopedTiming tic(m->fstats.at("BFGS"));
+    // Gradient of the Lagrangian at the new point
+    casadi_copy(d->gf, nx_, d->gLag);
+    casadi_mv(d->Jk, Asp_, d_nlp->lam + nx_, d->gLag, true);
+    casadi_axpy(nx_, 1., d_nlp->lam, d->gLag);
+    // Update the previous Hessian approximation, unless the point did not move
+    casadi_copy(get_ptr(m->rti_bk), Hsp_.nnz(), d->Bk);
+    if (casadi_norm_inf(nx_, d->dx) > 0) {
+      if (m->rti_iter % lbfgs_memory_ == 0) casadi_bfgs_reset(Hsp_, d->Bk);
+      if (hess_blk_.empty()) {
+        casadi_bfgs(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old, m->w);
+      } else {
+        casadi_bfgs_block(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old,
+          get_ptr(hess_blk_), n_hess_blk_, m->w);
+      }
+    }
+  }
+
+  // Store the linearization for the feedback phase
+  casadi_copy(d_nlp->z, nx_ + ng_, get_ptr(m->rti_z));
+  casadi_copy(d_nlp->lam, nx_ + ng_, get_ptr(m->rti_lam));
+  m->rti_f = d_nlp->objective;
+  casadi_copy(d->gf, nx_, get_ptr(m->rti_gf));
+  casadi_copy(d->Jk, Asp_.nnz(), get_ptr(m->rti_jk));
+  casadi_copy(d->Bk, Hsp_.nnz(), get_ptr(m->rti_bk));
+  m->rti_iter++;
+  return 0;
+}
+
+int Sqpmethod::rti_feedback(SqpmethodMemory* m) const {
+  auto d_nlp = &m->d_nlp;
+  auto d = &m->d;
+
+  // QP at the prepared linearization point with the current bounds
+  casadi_copy(get_ptr(m->rti_gf), nx_, d->gf);
+  casadi_copy(get_ptr(m->rti_jk), Asp_.nnz(), d->Jk);
+  casadi_copy(get_ptr(m->rti_bk), Hsp_.nnz(), d->Bk);
+  casadi_copy(d_nlp->lbz, nx_+ng_, d->lbdz);
+  casadi_axpy(nx_+ng_, -1., get_ptr(m->rti_z), d->lbdz);
+  casadi_copy(d_nlp->ubz, nx_+ng_, d->ubdz);
+  casadi_axpy(nx_+ng_, -1., get_ptr(m->rti_z), d->ubdz);
+  casadi_copy(get_ptr(m->rti_lam), nx_+ng_, d->dlam);
+  casadi_clear(d->dx, nx_);
+  m->iter_count = 1;
+  solve_QP(m, d->Bk, d->gf, d->lbdz, d->ubdz, d->Jk, d->dx, d->dlam, 0);
+  auto m_qpsol = static_cast<ConicMemory*>(qpsol_->memory(m->mem_qp));
+  m->success = m_qpsol->d_qp.success;
+  m->unified_return_status = m_qpsol->d_qp.unified_return_status;
+  m->return_status = m->success ? "Solve_Succeeded" : "QP_Failed";
+
+  // Full step, constraints and objective from the linearization
+  casadi_copy(get_ptr(m->rti_z), nx_ + ng_, d_nlp->z);
+  casadi_axpy(nx_, 1., d->dx, d_nlp->z);
+  casadi_mv(d->Jk, Asp_, d->dx, d_nlp->z + nx_, false);
+  d_nlp->objective = m->rti_f + casadi_dot(nx_, d->gf, d->dx);
+  casadi_copy(d->dlam, nx_ + ng_, d_nlp->lam);
+  return 0;
+}
+
+int Sqpmethod::solve_rti(SqpmethodMemory* m) const {
+  casadi_assert(m->rti_phase>=0 && m->rti_phase<=2,
+    "rti_phase must be 0 (prepare and feedback), 1 (prepare) or 2 (feedback), "
+    "got " + str(m->rti_phase));
+  m->iter_count = 0;
+
+  // Preparation phase, also when no QP has been prepared before a feedback phase
+  if (m->rti_phase!=2 || m->rti_iter==0) {
+    m->return_status = "Preparation_Failed";
+    if (rti_prepare(m)) {
+      // Start over with a fresh preparation phase
+      m->rti_iter = 0;
+      return 1;
+    }
+    if (m->rti_phase==1) {
+      m->success = true;
+      m->unified_return_status = SOLVER_RET_SUCCESS;
+      m->return_status = "Preparation_Succeeded";
+      return 0;
+    }
+  }
+
+  // Feedback phase
+  return rti_feedback(m);
+}
+
 int Sqpmethod::solve(void* mem) const {
   auto m = static_cast<SqpmethodMemory*>(mem);
   auto d_nlp = &m->d_nlp;
   auto d = &m->d;
 
+  // Real-time iteration
+  if (rti_) return solve_rti(m);
+
   // Number of SQP iterations
   m->iter_count = 0;
 
@@ -532,7 +774,12 @@ int Sqpmethod::solve(void* mem) const {
       // Update BFGS
       if (m->iter_count % lbfgs_memory_ == 0) casadi_bfgs_reset(Hsp_, d->Bk);
       // Update the Hessian approximation
-      casadi_bfgs(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old, m->w);
+      if (hess_blk_.empty()) {
+        casadi_bfgs(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old, m->w);
+      } else {
+        casadi_bfgs_block(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old,
+          get_ptr(hess_blk_), n_hess_blk_, m->w);
+      }
     }
 
     // Formulate the QP
@@ -735,6 +982,10 @@ int Sqpmethod::solve(void* mem) const {
       //double meritmax = casadi_vfmax(d->merit_mem+1,
       //  std::min(merit_memsize_, static_cast<casadi_int>(m->iter_count))-1, d->merit_mem[0]);
 
+      // Batched evaluation: results available and consumed so far
+      bool ls_batch_ok = ls_batch_>1;
+      casadi_int ls_nb = 0, ls_ib = 0;
+
       // Line-search loop
       while (true) {
         // Increase counter
@@ -745,7 +996,36 @@ int Sqpmethod::solve(void* mem) const {
         casadi_axpy(nx_, t, d->dx, d->z_cand);
 
         // Evaluating objective and constraints
-        if (!so_corr_ || !so_succes) {
+        bool batched = false;
+        if ((!so_corr_ || !so_succes) && ls_batch_ok) {
+          // Evaluate the next ls_batch_ step lengths t, beta*t, ... concurrently
+          if (ls_ib==ls_nb) {
+            double tb = t;
+            for (casadi_int k=0; k<ls_batch_; ++k) {
+              casadi_copy(d_nlp->z, nx_, get_ptr(m->ls_x) + k*nx_);
+              casadi_axpy(nx_, tb, d->dx, get_ptr(m->ls_x) + k*nx_);
+              tb = beta_ * tb;
+            }
+            m->arg[0] = get_ptr(m->ls_x);
+            m->arg[1] = d_nlp->p;
+            m->res[0] = get_ptr(m->ls_f);
+            m->res[1] = get_ptr(m->ls_g);
+            if (calc_function(m, "nlp_fg_batch")) {
+              // Fall back to sequential evaluation to locate the failing candidates
+              ls_batch_ok = false;
+            } else {
+              ls_nb = ls_batch_;
+              ls_ib = 0;
+            }
+          }
+          if (ls_batch_ok) {
+            fk_cand = m->ls_f[ls_ib];
+            casadi_copy(get_ptr(m->ls_g) + ls_ib*ng_, ng_, d->z_cand + nx_);
+            ls_ib++;
+            batched = true;
+          }
+        }
+        if (!batched && (!so_corr_ || !so_succes)) {
           m->arg[0] = d->z_cand;
           m->arg[1] = d_nlp->p;
           m->res[0] = &fk_cand;
@@ -1024,7 +1304,7 @@ double Sqpmethod::calc_gamma_1(SqpmethodMemory* m) const {
 void Sqpmethod::codegen_declarations(CodeGenerator& g) const {
   Nlpsol::codegen_declarations(g);
 
-  if (max_iter_ls_ || so_corr_) g.add_dependency(get_function("nlp_fg"));
+  if (!rti_ && (max_iter_ls_ || so_corr_)) g.add_dependency(get_function("nlp_fg"));
   g.add_dependency(get_function("nlp_jac_fg"));
   if (exact_hessian_) g.add_dependency(get_function("nlp_hess_l"));
   if (calc_f_ || calc_g_ || calc_lam_x_ || calc_lam_p_)
@@ -1032,10 +1312,142 @@ void Sqpmethod::codegen_declarations(CodeGenerator& g) const {
   g.add_dependency(qpsol_);
   if (elastic_mode_) g.add_dependency(qpsol_ela_);
   if (!exact_hessian_) g.add_auxiliary(CodeGenerator::AUX_BFGS);
+
+  if (rti_) {
+    // Prepared linearization and number of preparation phases, per memory object
+    std::string name = codegen_name(g, false);
+    casadi_int sz = 3*(nx_+ng_) + 1 + Asp_.nnz() + Hsp_.nnz();
+    g.auxiliaries << "static casadi_real " << g.shorthand(name + "_rti")
+                  << "[CASADI_MAX_NUM_THREADS][" << sz << "];\n";
+    g.auxiliaries << "static casadi_int " << g.shorthand(name + "_rti_iter")
+                  << "[CASADI_MAX_NUM_THREADS];\n";
+  }
+}
+
+void Sqpmethod::codegen_rti_prepare(CodeGenerator& g) const {
+  std::string name = codegen_name(g, false);
+  std::string rti_iter = g.shorthand(name + "_rti_iter") + "[mem]";
+  // Layout of the prepared linearization: z, lam, f, gf, Jk, Bk
+  std::string rti = g.shorthand(name + "_rti") + "[mem]";
+  std::string rti_z = rti;
+  std::string rti_lam = rti + "+" + str(nx_+ng_);
+  std::string rti_f = rti + "[" + str(2*(nx_+ng_)) + "]";
+  std::string rti_gf = rti + "+" + str(2*(nx_+ng_)+1);
+  std::string rti_jk = rti + "+" + str(3*nx_+2*ng_+1);
+  std::string rti_bk = rti + "+" + str(3*nx_+2*ng_+1+Asp_.nnz());
+
+  if (!exact_hessian_) {
+    g << "if (" << rti_iter << ">0) {\n";
+    g.comment("Step and gradient of the Lagrangian at the previous point with the new multipliers");
+    g << g.copy("d_nlp.z", nx_, "d->dx") << "\n";
+    g << g.axpy(nx_, "-1.0", rti_z, "d->dx") << "\n";
+    g << g.copy(rti_gf, nx_, "d->gLag_old") << "\n";
+    g << g.mv(rti_jk, Asp_, "d_nlp.lam+"+str(nx_), "d->gLag_old", true) << "\n";
+    g << g.axpy(nx_, "1.0", "d_nlp.lam", "d->gLag_old") << "\n";
+    g << "}\n";
+  }
+  g.comment("Evaluate f, g and first order derivative information");
+  g << "d->arg[0] = d_nlp.z;\n";
+  g << "d->arg[1] = d_nlp.p;\n";
+  g << "d->res[0] = &d_nlp.objective;\n";
+  g << "d->res[1] = d->gf;\n";
+  g << "d->res[2] = d_nlp.z+" + str(nx_) + ";\n";
+  g << "d->res[3] = d->Jk;\n";
+  std::string nlp_jac_fg = g(get_function("nlp_jac_fg"), "d->arg", "d->res", "d->iw", "d->w");
+  g << "if (" + nlp_jac_fg + ") {\n";
+  g << rti_iter << " = 0;\n";
+  g << "return 1;\n";
+  g << "}\n";
+  if (exact_hessian_) {
+    g.comment("Exact Hessian");
+    g << "d->arg[0] = d_nlp.z;\n";
+    g << "d->arg[1] = d_nlp.p;\n";
+    g.local("one", "const casadi_real");
+    g.init_local("one", "1");
+    g << "d->arg[2] = &one;\n";
+    g << "d->arg[3] = d_nlp.lam+" + str(nx_) + ";\n";
+    g << "d->res[0] = d->Bk;\n";
+    std::string nlp_hess_l = g(get_function("nlp_hess_l"), "d->arg", "d->res", "d->iw", "d->w");
+    std::string flag = nlp_hess_l;
+    if (convexify_) {
+      flag += " || " + g.convexify_eval(convexify_data_, "d->Bk", "d->Bk", "d->iw", "d->w");
+    }
+    g << "if (" + flag + ") {\n";
+    g << rti_iter << " = 0;\n";
+    g << "return 1;\n";
+    g << "}\n";
+  } else {
+    g << "if (" << rti_iter << "==0) {\n";
+    g.comment("Initialize BFGS");
+    g << g.fill("d->Bk", Hsp_.nnz(), "1.") << "\n";
+    g << "casadi_bfgs_reset(p.sp_h, d->Bk);\n";
+    g << "} else {\n";
+    g.comment("Gradient of the Lagrangian at the new point");
+    g << g.copy("d->gf", nx_, "d->gLag") << "\n";
+    g << g.mv("d->Jk", Asp_, "d_nlp.lam+"+str(nx_), "d->gLag", true) << "\n";
+    g << g.axpy(nx_, "1.0", "d_nlp.lam", "d->gLag") << "\n";
+    g.comment("Update the previous Hessian approximation, unless the point did not move");
+    g << g.copy(rti_bk, Hsp_.nnz(), "d->Bk") << "\n";
+    g << "if (" << g.norm_inf(nx_, "d->dx") << " > 0) {\n";
+    g << "if (" << rti_iter << " % " << lbfgs_memory_ << "==0) ";
+    g << "casadi_bfgs_reset(p.sp_h, d->Bk);\n";
+    if (hess_blk_.empty()) {
+      g << "casadi_bfgs(p.sp_h, d->Bk, d->dx, d->gLag, d->gLag_old, d->w);\n";
+    } else {
+      g << "casadi_bfgs_block(p.sp_h, d->Bk, d->dx, d->gLag, d->gLag_old, "
+        << g.constant(hess_blk_) << ", " << n_hess_blk_ << ", d->w);\n";
+    }
+    g << "}\n";
+    g << "}\n";
+  }
+  g.comment("Store the linearization for the feedback phase");
+  g << g.copy("d_nlp.z", nx_+ng_, rti_z) << "\n";
+  g << g.copy("d_nlp.lam", nx_+ng_, rti_lam) << "\n";
+  g << rti_f << " = d_nlp.objective;\n";
+  g << g.copy("d->gf", nx_, rti_gf) << "\n";
+  g << g.copy("d->Jk", Asp_.nnz(), rti_jk) << "\n";
+  g << g.copy("d->Bk", Hsp_.nnz(), rti_bk) << "\n";
+  g << rti_iter << "++;\n";
+}
+
+void Sqpmethod::codegen_rti_feedback(CodeGenerator& g) const {
+  std::string name = codegen_name(g, false);
+  std::string rti = g.shorthand(name + "_rti") + "[mem]";
+  std::string rti_z = rti;
+  std::string rti_lam = rti + "+" + str(nx_+ng_);
+  std::string rti_f = rti + "[" + str(2*(nx_+ng_)) + "]";
+  std::string rti_gf = rti + "+" + str(2*(nx_+ng_)+1);
+  std::string rti_jk = rti + "+" + str(3*nx_+2*ng_+1);
+  std::string rti_bk = rti + "+" + str(3*nx_+2*ng_+1+Asp_.nnz());
+
+  g.comment("QP at the prepared linearization point with the current bounds");
+  g << g.copy(rti_gf, nx_, "d->gf") << "\n";
+  g << g.copy(rti_jk, Asp_.nnz(), "d->Jk") << "\n";
+  g << g.copy(rti_bk, Hsp_.nnz(), "d->Bk") << "\n";
+  g << g.copy("d_nlp.lbz", nx_+ng_, "d->lbdz") << "\n";
+  g << g.axpy(nx_+ng_, "-1.0", rti_z, "d->lbdz") << "\n";
+  g << g.copy("d_nlp.ubz", nx_+ng_, "d->ubdz") << "\n";
+  g << g.axpy(nx_+ng_, "-1.0", rti_z, "d->ubdz") << "\n";
+  g << g.copy(rti_lam, nx_+ng_, "d->dlam") << "\n";
+  g << g.clear("d->dx", nx_) << "\n";
+  codegen_qp_solve(g, "d->Bk", "d->gf", "d->lbdz", "d->ubdz", "d->Jk", "d->dx", "d->dlam", 0);
+  g.comment("Full step, constraints and objective from the linearization");
+  g << g.copy(rti_z, nx_+ng_, "d_nlp.z") << "\n";
+  g << g.axpy(nx_, "1.0", "d->dx", "d_nlp.z") << "\n";
+  g << g.mv("d->Jk", Asp_, "d->dx", "d_nlp.z+"+str(nx_), false) << "\n";
+  g << "d_nlp.objective = " << rti_f << " + " << g.dot(nx_, "d->gf", "d->dx") << ";\n";
+  g << g.copy("d->dlam", nx_+ng_, "d_nlp.lam") << "\n";
 }
 
 void Sqpmethod::codegen_body(CodeGenerator& g) const {
   g.add_auxiliary(CodeGenerator::AUX_SQPMETHOD);
+  if (rti_) {
+    // Real-time iteration phase, before the extra input is used as work
+    g.local("rti_phase", "casadi_int");
+    g << "rti_phase = arg[" << NLPSOL_NUM_IN << "] ? "
+      << "(casadi_int) *arg[" << NLPSOL_NUM_IN << "] : 0;\n";
+    g << "if (rti_phase<0 || rti_phase>2) return 1;\n";
+  }
   codegen_body_enter(g);
   // From nlpsol
 
@@ -1052,6 +1464,21 @@ void Sqpmethod::codegen_body(CodeGenerator& g) const {
   g << "casadi_sqpmethod_init(d, &arg, &res, &iw, &w, "
     << elastic_mode_ << ", " << so_corr_ << ");\n";
 
+  if (rti_) {
+    g.local("ret", "int");
+    std::string rti_iter = g.shorthand(codegen_name(g, false) + "_rti_iter") + "[mem]";
+    g.comment("Preparation phase, also when no QP has been prepared before a feedback phase");
+    g << "if (rti_phase!=2 || " << rti_iter << "==0) {\n";
+    codegen_rti_prepare(g);
+    g << "}\n";
+    g.comment("Feedback phase");
+    g << "if (rti_phase!=1) {\n";
+    codegen_rti_feedback(g);
+    g << "}\n";
+    codegen_body_exit(g);
+    return;
+  }
+
   if (elastic_mode_) {
     g.local("gamma_1", "double");
     g.local("ela_it", "casadi_int");
@@ -1137,7 +1564,12 @@ void Sqpmethod::codegen_body(CodeGenerator& g) const {
     g << "if (iter_count % " << lbfgs_memory_ << "==0) ";
     g << "casadi_bfgs_reset(p.sp_h, d->Bk);\n";
     g.comment("Update the Hessian approximation");
-    g << "casadi_bfgs(p.sp_h, d->Bk, d->dx, d->gLag, d->gLag_old, d->w);\n";
+    if (hess_blk_.empty()) {
+      g << "casadi_bfgs(p.sp_h, d->Bk, d->dx, d->gLag, d->gLag_old, d->w);\n";
+    } else {
+      g << "casadi_bfgs_block(p.sp_h, d->Bk, d->dx, d->gLag, d->gLag_old, "
+        << g.constant(hess_blk_) << ", " << n_hess_blk_ << ", d->w);\n";
+    }
     g << "}\n";
   }
 
@@ -1537,7 +1969,7 @@ Dict Sqpmethod::get_stats(void* mem) const {
 }
 
 Sqpmethod::Sqpmethod(DeserializingStream& s) : Nlpsol(s) {
-  int version = s.version("Sqpmethod", 1, 3);
+  int version = s.version("Sqpmethod", 1, 6);
   s.unpack("Sqpmethod::qpsol", qpsol_);
   if (version>=3) {
     s.unpack("Sqpmethod::qpsol_ela", qpsol_ela_);
@@ -1546,12 +1978,28 @@ Sqpmethod::Sqpmethod(DeserializingStream& s) : Nlpsol(s) {
   s.unpack("Sqpmethod::max_iter", max_iter_);
   s.unpack("Sqpmethod::min_iter", min_iter_);
   s.unpack("Sqpmethod::lbfgs_memory", lbfgs_memory_);
+  if (version>=4) {
+    s.unpack("Sqpmethod::hess_blk", hess_blk_);
+    s.unpack("Sqpmethod::n_hess_blk", n_hess_blk_);
+  } else {
+    n_hess_blk_ = 0;
+  }
+  if (version>=5) {
+    s.unpack("Sqpmethod::rti", rti_);
+  } else {
+    rti_ = false;
+  }
   s.unpack("Sqpmethod::tol_pr_", tol_pr_);
   s.unpack("Sqpmethod::tol_du_", tol_du_);
   s.unpack("Sqpmethod::min_step_size_", min_step_size_);
   s.unpack("Sqpmethod::c1", c1_);
   s.unpack("Sqpmethod::beta", beta_);
   s.unpack("Sqpmethod::max_iter_ls_", max_iter_ls_);
+  if (version>=6) {
+    s.unpack("Sqpmethod::ls_batch", ls_batch_);
+  } else {
+    ls_batch_ = 1;
+  }
   s.unpack("Sqpmethod::merit_memsize_", merit_memsize_);
   s.unpack("Sqpmethod::beta", beta_);
   s.unpack("Sqpmethod::print_header", print_header_);
@@ -1611,19 +2059,23 @@ Sqpmethod::Sqpmethod(DeserializingStream& s) : Nlpsol(s) {
 
 void Sqpmethod::serialize_body(SerializingStream &s) const {
   Nlpsol::serialize_body(s);
-  s.version("Sqpmethod", 3);
+  s.version("Sqpmethod", 6);
   s.pack("Sqpmethod::qpsol", qpsol_);
   s.pack("Sqpmethod::qpsol_ela", qpsol_ela_);
   s.pack("Sqpmethod::exact_hessian", exact_hessian_);
   s.pack("Sqpmethod::max_iter", max_iter_);
   s.pack("Sqpmethod::min_iter", min_iter_);
   s.pack("Sqpmethod::lbfgs_memory", lbfgs_memory_);
+  s.pack("Sqpmethod::hess_blk", hess_blk_);
+  s.pack("Sqpmethod::n_hess_blk", n_hess_blk_);
+  s.pack("Sqpmethod::rti", rti_);
   s.pack("Sqpmethod::tol_pr_", tol_pr_);
   s.pack("Sqpmethod::tol_du_", tol_du_);
   s.pack("Sqpmethod::min_step_size_", min_step_size_);
   s.pack("Sqpmethod::c1", c1_);
   s.pack("Sqpmethod::beta", beta_);
   s.pack("Sqpmethod::max_iter_ls_", max_iter_ls_);
+  s.pack("Sqpmethod::ls_batch", ls_batch_);
   s.pack("Sqpmethod::merit_memsize_", merit_memsize_);
   s.pack("Sqpmethod::beta", beta_);
   s.pack("Sqpmethod::print_header", print_header_);
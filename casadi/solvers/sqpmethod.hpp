@@ -59,6 +59,22 @@ namespace casadi {
 
     /// Iteration count
     int iter_count;
+
+    /// Batched line-search: candidate points, objective and constraint values
+    std::vector<double> ls_x, ls_f, ls_g;
+
+    /// Real-time iteration: phase requested in the current call
+    casadi_int rti_phase;
+
+    /// Real-time iteration: number of preparation phases, zero if none is available
+    casadi_int rti_iter;
+
+    /// Real-time iteration: linearization point (x and g) and multipliers
+    std::vector<double> rti_z, rti_lam;
+
+    /// Real-time iteration: prepared objective, gradient, Jacobian and Hessian
+    double rti_f;
+    std::vector<double> rti_gf, rti_jk, rti_bk;
   };
 
   /** \brief  \pluginbrief{Nlpsol,sqpmethod}
@@ -102,6 +118,24 @@ namespace casadi {
     /** \brief Free memory block */
     void free_mem(void* mem) const override;
 
+    ///@{
+    /** \brief Number of function inputs, extended by the phase in real-time iteration mode */
+    size_t get_n_in() override { return NLPSOL_NUM_IN + rti_;}
+    ///@}
+
+    /// @{
+    /** \brief Sparsities, names and default values of function inputs */
+    Sparsity get_sparsity_in(casadi_int i) override;
+    std::string get_name_in(casadi_int i) override;
+    double get_default_in(casadi_int ind) const override;
+    /// @}
+
+    ///@{
+    /** \brief No sensitivities of a single real-time iteration */
+    bool has_forward(casadi_int nfwd) const override { return !rti_;}
+    bool has_reverse(casadi_int nadj) const override { return !rti_;}
+    ///@}
+
     /** \brief Set the (persistent) work vectors */
     void set_work(void* mem, const double**& arg, double**& res,
                           casadi_int*& iw, double*& w) const override;
@@ -130,6 +164,10 @@ namespace casadi {
     /// Memory size of L-BFGS method
     casadi_int lbfgs_memory_;
 
+    /// Partitioned BFGS: block of each variable and number of blocks
+    std::vector<casadi_int> hess_blk_;
+    casadi_int n_hess_blk_;
+
     /// Tolerance of primal and dual infeasibility
     double tol_pr_, tol_du_;
 
@@ -150,6 +188,9 @@ namespace casadi {
     double c1_;
     double beta_;
     casadi_int max_iter_ls_;
+
+    // Number of step lengths evaluated concurrently in the line-search
+    casadi_int ls_batch_;
     casadi_int merit_memsize_;
     ///@}
 
@@ -171,6 +212,22 @@ namespace casadi {
     // Second order corrections
     bool so_corr_;
 
+    // Real-time iteration mode
+    bool rti_;
+
+    // Real-time iteration: preparation and/or feedback phase, depending on rti_phase
+    int solve_rti(SqpmethodMemory* m) const;
+
+    // Real-time iteration: linearize at the current iterate
+    int rti_prepare(SqpmethodMemory* m) const;
+
+    // Real-time iteration: solve the prepared QP with the current bounds
+    int rti_feedback(SqpmethodMemory* m) const;
+
+    // Real-time iteration: generate code for the preparation and feedback phases
+    void codegen_rti_prepare(CodeGenerator& g) const;
+    void codegen_rti_feedback(CodeGenerator& g) const;
+
     /** \brief Generate code for the function body */
     void codegen_body(CodeGenerator& g) const override;
 
@@ -952,6 +952,105 @@ class ConicTests(casadiTestCase):
     
     
 
+  def test_condensing(self):
+    N = 6
+    x = SX.sym('x',2)
+    u = SX.sym('u')
+    F = Function('F', [x, u], [vertcat(x[0]+0.1*x[1], x[1]+0.1*u-0.01)])
+
+    Xs = SX.sym('X', 2, 1, N+1)
+    Us = SX.sym('U', 1, 1, N)
+    w = []; lbw = []; ubw = []
+    g = []; lbg = []; ubg = []
+    J = 0
+    for k in range(N):
+      w += [Xs[k], Us[k]]
+      if k==0:
+        lbw += [1, 0.5, -2]
+        ubw += [1, 0.5, 2]
+      else:
+        lbw += [-inf, 0.45, -2]
+        ubw += [inf, inf, 2]
+      J += dot(Xs[k],Xs[k]) + 0.1*Us[k]**2 - 0.3*Xs[k][0]*Us[k]
+      g += [3*(F(Xs[k],Us[k])-Xs[k+1])]
+      lbg += [0, 0]
+      ubg += [0, 0]
+      g += [Us[k]+Xs[k][1]]
+      lbg += [-0.5]
+      ubg += [0.5]
+    w += [Xs[-1]]
+    lbw += [-inf, 0.45]
+    ubw += [inf, inf]
+    J += dot(Xs[-1],Xs[-1])
+    prob = {'f': J, 'x': vertcat(*w), 'g': vertcat(*g)}
+    args = dict(lbx=lbw, ubx=ubw, lbg=lbg, ubg=ubg)
+
+    qrqp_opts = {"print_iter":False,"print_header":False,"print_info":False}
+    sol_ref = qpsol('solver', 'qrqp', prob, qrqp_opts)(**args)
+    for block_size in [0, 2, 3]:
+      solver = qpsol('solver', 'condensing', prob, {"conic":"qrqp","conic_options":qrqp_opts,
+                     "N":N,"nx":[2]*(N+1),"nu":[1]*N,"ng":[1]*N+[0],"block_size":block_size})
+      sol = solver(**args)
+      self.checkarray(sol["x"],sol_ref["x"],digits=8)
+      self.checkarray(sol["f"],sol_ref["f"],digits=8)
+      self.checkarray(sol["lam_x"],sol_ref["lam_x"],digits=8)
+      self.checkarray(sol["lam_g"],sol_ref["lam_g"],digits=8)
+
+  def test_presolve(self):
+    x = SX.sym('x',5)
+    J = x[0]**2 + 2*x[1]**2 + x[2]**2 + x[0]*x[1] + 0.5*x[2]*x[3] + x[3]**2 + 1e3*x[4]**2 - x[0] + x[3] + 10*x[4]
+    g = vertcat(x[0]+x[1]+x[2]+x[3], 3*x[1], 100*x[0]+100*x[2], -2*x[4], 1e-2*x[2]+1e2*x[4])
+    prob = {'f': J, 'x': x, 'g': g}
+    args = dict(lbx=[-10,-10,-10,2,-10], ubx=[10,10,10,2,10],
+                lbg=[1,-inf,-inf,-1,-inf], ubg=[inf,-1.5,1e4,inf,5])
+
+    qrqp_opts = {"print_iter":False,"print_header":False,"print_info":False}
+    sol_ref = qpsol('solver', 'qrqp', prob, qrqp_opts)(**args)
+    for scaling in [0, 10]:
+      opts = dict(qrqp_opts)
+      opts["presolve"] = True
+      opts["presolve_scaling"] = scaling
+      solver = qpsol('solver', 'qrqp', prob, opts)
+      sol = solver(**args)
+      self.checkarray(sol["x"],sol_ref["x"],digits=8)
+      self.checkarray(sol["f"],sol_ref["f"],digits=8)
+      self.checkarray(sol["lam_x"],sol_ref["lam_x"],digits=8)
+      self.checkarray(sol["lam_g"],sol_ref["lam_g"],digits=8)
+      stats = solver.stats()
+      self.assertEqual(stats["n_fixed"],1)
+      self.assertEqual(stats["n_singleton_rows"],2)
+      self.assertEqual(stats["n_redundant_rows"],1)
+
+  def test_presolve_feasible(self):
+    # Scaled problem on which qrqp used to stop with a violated active constraint
+    H = DM([[0.76443751072357546, 0.031372946609164912, -0.21129185492412911, 0.13825771047675159, 0.099106078312762483],
+            [0.031372946609164912, 0.47962653785106268, -0.013517571919460056, 0.27781695990612193, -0.18523173163921336],
+            [-0.21129185492412911, -0.013517571919460056, 0.21441588880846227, -0.1180349589532247, 0.064069430036864786],
+            [0.13825771047675159, 0.27781695990612193, -0.1180349589532247, 0.99734694076160468, 0.042097154850409491],
+            [0.099106078312762483, -0.18523173163921336, 0.064069430036864786, 0.042097154850409491, 0.70159367567508668]])
+    g = DM([0.082425256707096439, -0.010740935941361385, -0.76878060896207101, 0.56725544824254914, 0.48974630261945262])
+    A = DM([[0, 0.19788384362002431, -1.2849938464773389, 0.29814277607588924, -0.77136353568157956]])
+    args = dict(h=H, g=g, a=A,
+                lbx=[-0.99584554573841111, -0.1300154956356574, 0.15129192481121378, -0.66191922894434452, -0.014740946247538744],
+                ubx=[-0.097747360380228604, 0.82324365722733961, 1.3232427010475423, 0.11094165305991999, 1.2052437488316623],
+                lba=-1.4735819308925109, uba=inf)
+
+    qrqp_opts = {"print_iter":False,"print_header":False,"print_info":False}
+    sol_ref = conic('solver', 'qrqp', {'h':H.sparsity(), 'a':A.sparsity()}, qrqp_opts)(**args)
+    opts = dict(qrqp_opts)
+    opts["presolve"] = True
+    opts["presolve_scaling"] = 10
+    solver = conic('solver', 'qrqp', {'h':H.sparsity(), 'a':A.sparsity()}, opts)
+    sol = solver(**args)
+    stats = solver.stats()
+    self.assertTrue(stats["success"])
+    self.assertTrue(stats["postsolve_pr"]<=1e-10)
+    self.assertTrue(float(mmin(sol["x"]-DM(args["lbx"])))>=-1e-10)
+    self.assertTrue(float(mmax(sol["x"]-DM(args["ubx"])))<=1e-10)
+    self.assertTrue(float(mtimes(A,sol["x"]))>=args["lba"]-1e-10)
+    self.checkarray(sol["x"],sol_ref["x"],digits=8)
+    self.checkarray(sol["cost"],sol_ref["cost"],digits=8)
+
   @requires_conic("hpipm")
   @requires_conic("qpoases")
   def test_hpipm(self):
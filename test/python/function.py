@@ -29,6 +29,7 @@ from types import *
 from helpers import *
 import pickle
 import os
+import glob
 import sys
 
 scipy_interpolate = False
@@ -629,6 +630,28 @@ class Functiontests(casadiTestCase):
     self.checkfunction_light(fun.map(4,"thread",2),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
     self.checkfunction_light(fun.map(4,"thread",5),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
 
+  def test_map_codegen_simd(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+    v = SX.sym("z",Sparsity.upper(3))
+
+    fun = Function("f",[x,y,v],[sin(y*x).T,v/x,fmax(x,y[0])])
+
+    for n in [3,4,11]:
+      inputs = [np.random.random((1,n)),np.random.random((2,n)),
+                DM(repmat(v.sparsity(),1,n),np.random.random(6*n))]
+      for opts in [{"simd":4},{"simd":4,"avoid_stack":True}]:
+        self.check_codegen(fun.map(n),inputs=inputs,opts=opts)
+
+    # The work vector of a batch is only reserved in generated code
+    self.assertEqual(fun.map(100).sz_w(),fun.sz_w())
+    # Maps embedded in an MX function
+    args = [MX.sym("x",1,n),MX.sym("y",2,n),MX.sym("v",repmat(v.sparsity(),1,n))]
+    r = fun.map(n)(*args)
+    g = Function("g",args,[2*r[0],r[1]+args[0][0],r[2]])
+    for opts in [{"simd":4},{"simd":4,"avoid_stack":True}]:
+      self.check_codegen(g,inputs=inputs,opts=opts)
+
   @memory_heavy()
   def test_mapsum(self):
     x = SX.sym("x")
@@ -1974,6 +1997,153 @@ class Functiontests(casadiTestCase):
     self.check_codegen(f,inputs=[np.random.random((3,3))])
     self.check_codegen(f,inputs=[np.random.random((3,3))], opts={"avoid_stack": True})
 
+  def test_codegen_profile(self):
+    x = MX.sym("x",2)
+    g = Function('g',[x],[sin(x)*x[0]])
+    f = Function('f',[x],[g(g(x))+x])
+    self.check_codegen(f,inputs=[[0.3,0.7]],opts={"profile":True})
+    with self.assertInException("cannot be combined"):
+      CodeGenerator("f",{"profile":True,"split":1000})
+
+    # The accessors report the calls of each function
+    self.check_codegen(f,inputs=[[0.3,0.7]],opts={"profile":True},driver="""
+#include <string.h>
+int main(void) {
+  casadi_int i, n_call, sz_arg, sz_res, sz_iw, sz_w, iw[100];
+  casadi_real w[100], x[2] = {0.3, 0.7}, y[2];
+  const casadi_real* arg[10];
+  casadi_real* res[10];
+  const char* name;
+  double t;
+  if (f_work(&sz_arg, &sz_res, &sz_iw, &sz_w)) return 1;
+  if (sz_arg>10 || sz_res>10 || sz_iw>100 || sz_w>100) return 1;
+  arg[0] = x;
+  res[0] = y;
+  for (i=0; i<3; ++i) if (f(arg, res, iw, w, 0)) return 1;
+  if (CODEGEN(profile_n)()!=2) return 2;
+  for (i=0; i<2; ++i) {
+    if (CODEGEN(profile)(i, &name, &n_call, &t) || t<0) return 3;
+    if ((strcmp(name, "f") && strcmp(name, "g")) || n_call!=3) return 4;
+  }
+  return !CODEGEN(profile)(i, &name, &n_call, &t);
+}
+""")
+
+  def test_codegen_mem_pool(self):
+    x = MX.sym("x",2)
+    p = MX.sym("p")
+    nlp = {"x":x,"p":p,"f":(x[0]-p)**2+(x[1]-x[0]**2)**2,"g":x[0]+x[1]}
+    solver = nlpsol("solver","sqpmethod",nlp,{"qpsol":"qrqp","print_time":False,
+      "print_iteration":False,"print_header":False,
+      "qpsol_options":{"print_iter":False,"print_header":False}})
+    inputs = {"x0":[0.5,0.5],"p":0.7,"lbg":-1,"ubg":1}
+    for opts in [{"mem_pool":1},{"mem_pool":4,"with_header":True}]:
+      self.check_codegen(solver,inputs=inputs,opts=opts,std="c99")
+    with self.assertInException("cannot be combined"):
+      CodeGenerator("f",{"mem_pool":2,"with_mem":True})
+
+    # Entries from checkout and alloc_mem are claimed from one bounded pool
+    self.check_codegen(solver,inputs=inputs,opts={"mem_pool":2},std="c99",driver="""
+int main(void) {
+  int i, m[2];
+  for (i=0; i<2; ++i) if ((m[i]=solver_checkout())<0) return 1;
+  if (solver_checkout()!=-1) return 2;
+  solver_release(m[1]);
+  if (solver_checkout()!=m[1]) return 3;
+  for (i=0; i<2; ++i) solver_release(m[i]);
+  for (i=0; i<2; ++i) if ((m[i]=solver_alloc_mem())<0 || solver_init_mem(m[i])) return 4;
+  if (solver_alloc_mem()!=-1 || solver_checkout()!=-1) return 5;
+  solver_free_mem(m[0]);
+  if (solver_checkout()!=m[0]) return 6;
+  return 0;
+}
+""")
+
+  def test_codegen_specialize(self):
+    A = MX.sym("A",Sparsity.banded(5,1))
+    B = MX.sym("B",Sparsity.lower(5))
+    C = MX.sym("C",4,3)
+    D = MX.sym("D",3,2)
+    f = Function('f',[A,B,C,D],[mtimes(A,B)+mtimes(B.T,A),mtimes(C,D),
+                                densify(A.T)+project(B,Sparsity.upper(5))])
+    np.random.seed(0)
+    inputs = [DM(A.sparsity(),np.random.random(A.nnz())),
+              DM(B.sparsity(),np.random.random(B.nnz())),
+              np.random.random((4,3)),np.random.random((3,2))]
+    for opts in [{"specialize":4},{"specialize":1000}]:
+      self.check_codegen(f,inputs=inputs,opts=opts)
+
+  def test_codegen_compress(self):
+    x = MX.sym("x",40)
+    v = MX.sym("v",12)
+    i1 = [0,1,2,3,4,5,10,12,14,16,18,20,7,7,7]
+    a = x[i1]
+    b = x[[i+11 for i in i1]]
+    c = x[[3,9,1,4,17]]
+    y = MX.zeros(40,1)
+    y[[30,31,32,33,20,22,24,26,1,2,3,4]] = v
+    z = densify(y)+x
+    z[list(range(5,17))] += v
+    f = Function('f',[x,v],[a*b,c,z])
+    np.random.seed(0)
+    self.check_codegen(f,inputs=[np.random.random(40),np.random.random(12)],opts={"compress":True})
+
+  def test_codegen_mixed_precision(self):
+    x = SX.sym("x",6)
+    e = [1e-4*sin(x[k]*(k+1))**2+1e4*x[k]*x[(k+2)%6] for k in range(6)]
+    f = Function('f',[x],[vertcat(*e),sum1(vertcat(*e)*exp(x/3))])
+    np.random.seed(0)
+    self.check_codegen(f,inputs=[2*np.random.random(6)-1],opts={"mixed_precision":1e-6},digits=5)
+    with self.assertInException("mixed_precision"):
+      CodeGenerator("f",{"mixed_precision":-1})
+    with self.assertInException("mixed_precision_range"):
+      CodeGenerator("f",{"mixed_precision_range":[1,-1]})
+    # Float locals are emitted and the error at random inputs stays within the tolerance
+    tol = 1e-2
+    opts = {"mixed_precision":tol,"mixed_precision_samples":16}
+    cg = CodeGenerator("f",opts)
+    cg.add(f)
+    self.assertTrue("float a" in cg.dump())
+    F, _ = self.check_codegen(f,inputs=[2*np.random.random(6)-1],opts=opts,digits=1)
+    for i in range(100):
+      x0 = 2*np.random.random(6)-1
+      for r, r_ref in zip(F(x0),f(x0)):
+        self.assertTrue(float(norm_inf(r-r_ref))<=tol)
+    # Operands of discontinuous operations stay in double, even with zero sensitivity
+    x = SX.sym("x",2)
+    f = Function('f',[x],[if_else(x[0]-0.1>0,1e3,0)+floor(x[1]*1e4)+x[0]*x[1]])
+    self.check_codegen(f,inputs=[[0.1-1e-10,0.30000001]],opts={"mixed_precision":1e-6},digits=5)
+
+  def test_codegen_fuse(self):
+    x = SX.sym("x",3)
+    p = SX.sym("p")
+    m = sin(x*p)+exp(x)
+    f1 = Function('f1',[x,p],[sum1(m),m])
+    f2 = Function('f2',[x,p],[m*m])
+    f3 = Function('f3',[x,p],[dot(m,x),jacobian(sum1(m),x)])
+    X = MX.sym("x",3)
+    P = MX.sym("p")
+    r1 = f1(X,P)
+    r3 = f3(X,P)
+    g = Function('g',[X,P],[3*r1[0]+r3[0],f2(X,P)+f2(2*X,P),r3[1],r1[1]])
+    for opts in [{"fuse":True},{"fuse":True,"reroll":2},{"fuse":True,"avoid_stack":True}]:
+      self.check_codegen(g,inputs=[[0.1,0.2,0.3],0.7],opts=opts)
+
+  def test_codegen_reroll(self):
+    x = SX.sym("x",50)
+    p = SX.sym("p",2)
+    s = 0
+    e = []
+    for k in range(50):
+      e.append(sin(x[k]*p[0]+k%3)*cos(x[k])+0.5*k)
+      s = s+e[-1]*p[1]
+    f = Function('f',[x,p],[vertcat(*e),s])
+    np.random.seed(0)
+    for opts in [{"reroll": 2},{"reroll": 3, "avoid_stack": True}]:
+      self.check_codegen(f,inputs=[np.random.random(50),[0.3,1.7]], opts=opts)
+    with self.assertInException("reroll"):
+      CodeGenerator("f",{"reroll":-1})
+
 
   def test_serialize(self):
     for opts in [{"debug":True},{}]:
@@ -2154,6 +2324,43 @@ class Functiontests(casadiTestCase):
         self.assertTrue("-1e-07," in out[0] or "-1e-007," in out[0] )
         self.assertTrue("1e-07," in out[0] or "1e-007," in out[0] )
 
+  @requiresPlugin(Importer,"shell")
+  def test_jit_split(self):
+    x = SX.sym("x",100)
+    e = vertcat(*[sin(x[k]*(1+k%7))*cos(x[(7*k)%100])+0.5*k for k in range(100)])
+    f = Function('f',[x],[e,dot(x,e)])
+    X = MX.sym("x",100)
+    g = Function('g',[X],[f(X)[1]+f(2*X)[1],f(X)[0]])
+    for split in [500,2000]:
+      gj = Function('g',[X],[f(X)[1]+f(2*X)[1],f(X)[0]],
+        {"jit":True,"compiler":"shell","jit_options":{"split":split}})
+      self.checkfunction_light(gj,g,inputs=[np.random.random(100)])
+      self.check_codegen(g,inputs=[np.random.random(100)],opts={"split":split})
+
+  @requiresPlugin(Importer,"shell")
+  def test_jit_incremental(self):
+    x = SX.sym("x",20)
+    X = MX.sym("x",20)
+    f = Function('f',[x],[sin(x)*cos(2*x)])
+    units = None
+    for c in [1,1,2]:
+      h = Function('h',[x],[c*exp(x)])
+      g = Function('g',[X],[f(X)+h(X)])
+      gj = Function('g',[X],[f(X)+h(X)],
+        {"jit":True,"compiler":"shell","jit_name":"jit_incremental","jit_temp_suffix":False,
+         "jit_options":{"incremental":True}})
+      self.checkfunction_light(gj,g,inputs=[np.random.random(20)])
+      # Sources and objects of the units
+      files = set(glob.glob("jit_incremental_*"))
+      if units is not None:
+        # Unchanged units are neither rewritten nor recompiled
+        for u in files & units: self.assertEqual(os.path.getmtime(u),0)
+        # Only the unit of h and its object are new, the ones they replace are removed
+        self.assertEqual(len(files-units),0 if c==1 else 2)
+        self.assertEqual(len(files),len(units))
+      for u in files: os.utime(u,(0,0))
+      units = files
+
   @requires_nlpsol("ipopt")
   @requiresPlugin(Importer,"shell")
   def test_inherit_jit_options(self):
@@ -33,6 +33,7 @@ import time
 from contextlib import contextmanager
 from casadi.tools import capture_stdout
 import os
+import glob
 
 codegen_check_digits = 15
 
@@ -697,7 +698,7 @@ class casadiTestCase(unittest.TestCase):
       if opts is None: opts = {}
       return (external(name, libname,opts),libname)
 
-  def check_codegen(self,F,inputs=None, opts=None,std="c89",extralibs="",check_serialize=False,extra_options=None,main=False,main_return_code=0,definitions=None,with_jac_sparsity=False,external_opts=None,with_reverse=False,with_forward=False,extra_include=[],digits=15):
+  def check_codegen(self,F,inputs=None, opts=None,std="c89",extralibs="",check_serialize=False,extra_options=None,main=False,main_return_code=0,definitions=None,with_jac_sparsity=False,external_opts=None,with_reverse=False,with_forward=False,extra_include=[],digits=15,driver=None):
     if not isinstance(main_return_code,list):
         main_return_code = [main_return_code]
     if args.run_slow:
@@ -705,6 +706,7 @@ class casadiTestCase(unittest.TestCase):
       name = "codegen_%s" % (hashlib.md5(("%f" % np.random.random()+str(F)+str(time.time())).encode()).hexdigest())
       if opts is None: opts = {}
       if main: opts["main"] = True
+      if driver is not None: opts["with_header"] = True
       cg = CodeGenerator(name,opts)
       cg.add(F,with_jac_sparsity)
       if with_reverse:
@@ -745,10 +747,13 @@ class casadiTestCase(unittest.TestCase):
       if definitions is None:
         definitions = []
 
-      def get_commands(shared=True):
+      # Translation units split off by the 'split' option
+      sources = " ".join([name + ".c"] + sorted(glob.glob(name + "_[0-9]*.c")))
+
+      def get_commands(shared=True,sources=sources,name=name):
         if os.name=='nt':
           defs = " ".join(["/D"+d for d in definitions])
-          commands = "cl.exe {shared} {definitions} {includedir} {name}.c {extra} /link  /libpath:{libdir}".format(shared="/LD" if shared else "",std=std,name=name,libdir=libdir,includedir=" ".join(["/I" + e for e in includedirs]),extra=extralibs + extra_options + extralibs + extra_options,definitions=defs)
+          commands = "cl.exe {shared} {definitions} {includedir} {sources} {extra} /link  /libpath:{libdir}".format(shared="/LD" if shared else "",std=std,sources=sources,libdir=libdir,includedir=" ".join(["/I" + e for e in includedirs]),extra=extralibs + extra_options + extralibs + extra_options,definitions=defs)
           if shared:
             output = "./" + name + ".dll"
           else:
@@ -757,7 +762,7 @@ class casadiTestCase(unittest.TestCase):
         else:
           defs = " ".join(["-D"+d for d in definitions])
           output = "./" + name + (".so" if shared else "")
-          commands = "gcc -pedantic -std={std} -fPIC {shared} -Wall -Werror -Wextra {includedir} -Wno-unknown-pragmas -Wno-long-long -Wno-unused-parameter -O3 {definitions} {name}.c -o {name_out} -L{libdir} -Wl,-rpath,{libdir} -Wl,-rpath,.".format(shared="-shared" if shared else "",std=std,name=name,name_out=name+(".so" if shared else ""),libdir=libdir,includedir=" ".join(["-I" + e for e in includedirs]),definitions=defs) + (" -lm" if not shared else "") + extralibs + extra_options
+          commands = "gcc -pedantic -std={std} -fPIC {shared} -Wall -Werror -Wextra {includedir} -Wno-unknown-pragmas -Wno-long-long -Wno-unused-parameter -O3 {definitions} {sources} -o {name_out} -L{libdir} -Wl,-rpath,{libdir} -Wl,-rpath,.".format(shared="-shared" if shared else "",std=std,sources=sources,name_out=name+(".so" if shared else ""),libdir=libdir,includedir=" ".join(["-I" + e for e in includedirs]),definitions=defs) + (" -lm" if not shared else "") + extralibs + extra_options
           if sys.platform=="darwin":
             commands+= " -Xlinker -rpath -Xlinker {libdir}".format(libdir=libdir)
             commands+= " -Xlinker -rpath -Xlinker .".format(libdir=libdir)
@@ -772,6 +777,19 @@ class casadiTestCase(unittest.TestCase):
       if external_opts is None: external_opts = {}
       F2 = external(F.name(), libname,external_opts)
 
+      # Custom C driver: includes the generated header, CODEGEN(x) expands to name_x
+      if driver is not None:
+        with open(name+"_driver.c","w") as out:
+          out.write('#include "%s.h"\n#define CODEGEN(x) %s_ ## x\n' % (name, name))
+          out.write(driver)
+        [commands, exename] = get_commands(shared=False,sources=name+"_driver.c "+sources,name=name+"_driver")
+        print("compile driver",commands)
+        self.assertEqual(subprocess.Popen(commands,shell=True).wait(),0)
+        p = subprocess.Popen(exename,shell=True)
+        p.communicate()
+        print("Return code",p.returncode)
+        assert p.returncode in main_return_code
+
       if main:
         [commands, exename] = get_commands(shared=False)
         print("here",commands)
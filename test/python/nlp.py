@@ -629,6 +629,187 @@ class NLPtests(casadiTestCase):
     s2 = solver.stats()
     self.assertEqual(s1["n_call_nlp_f"],s2["n_call_nlp_f"])
 
+  def test_parallel_blocks(self):
+    x = MX.sym("x",6)
+    p = MX.sym("p")
+    f = Function("f",[x,p],[sum1((x-p)**2)+sum1(x[1:]*x[:-1])**2])
+    g = vertcat(*[x[i]**2+sin(x[i+1])*p for i in range(5)])
+    nlp = {"x":x,"p":p,"f":f(x,p),"g":g}
+    args = dict(x0=0.1,p=0.3,lbg=-1,ubg=0.5)
+
+    opts = {"qpsol":"qrqp","print_header":False,"print_iteration":False,"print_time":False,
+            "qpsol_options":{"print_iter":False,"print_header":False,"print_info":False}}
+    ref = nlpsol("solver","sqpmethod",nlp,opts)(**args)
+    opts["expand"] = True
+    opts["parallel_blocks"] = 3
+    res = nlpsol("solver","sqpmethod",nlp,opts)(**args)
+    for k in ["x","f","lam_g"]:
+      self.checkarray(res[k],ref[k],digits=8)
+
+  def test_partitioned_bfgs(self):
+    x = SX.sym("x",4)
+    nlp = {"x":x,"f":(x[0]-1)**2+(x[0]*x[1]-2)**2+(x[2]+1)**2+x[3]**4+x[2]**2*x[3]**2,"g":x[0]+x[1]}
+    args = dict(x0=0.5,lbg=1,ubg=3)
+
+    opts = {"qpsol":"qrqp","hessian_approximation":"limited-memory","max_iter":200,
+            "print_header":False,"print_iteration":False,"print_time":False,
+            "qpsol_options":{"print_iter":False,"print_header":False,"print_info":False}}
+    ref = nlpsol("solver","sqpmethod",nlp,opts)(**args)
+    opts["partitioned_bfgs"] = True
+    opts["print_header"] = True
+    with self.assertOutput(["partitioned BFGS Hessian approximation (2 blocks)"],[]):
+      solver = nlpsol("solver","sqpmethod",nlp,opts)
+    res = solver(**args)
+    for k in ["x","f"]:
+      self.checkarray(res[k],ref[k],digits=5)
+
+  def test_sqpmethod_rti(self):
+    x=SX.sym("x")
+    y=SX.sym("y")
+    nlp={'x':vertcat(x,y), 'f':(1-x)**2+(y-x**2)**2, 'g':x**2+y**2}
+    inputs = dict(x0=[0.5,0.5],lbg=0,ubg=1)
+
+    opts = {"qpsol":"qrqp","print_header":False,"print_iteration":False,"print_time":False,
+            "qpsol_options":{"print_iter":False,"print_header":False,"print_info":False}}
+    ref = nlpsol("solver","sqpmethod",nlp,opts)(**inputs)
+    for hessian_approximation in ["exact","limited-memory"]:
+      opts["hessian_approximation"] = hessian_approximation
+      opts["rti"] = True
+      solver = nlpsol("solver","sqpmethod",nlp,opts)
+      self.assertEqual(solver.name_in(solver.n_in()-1),"rti_phase")
+      # Full steps, each warm started at the previous iterate
+      res = solver(**inputs)
+      for i in range(30):
+        res = solver(x0=res["x"],lam_x0=res["lam_x"],lam_g0=res["lam_g"],lbg=0,ubg=1)
+        self.assertTrue(solver.stats()["success"])
+      self.checkarray(res["x"],ref["x"],digits=7)
+      self.checkarray(res["lam_g"],ref["lam_g"],digits=7)
+
+      # Separate preparation and feedback phases give the same step
+      solver = nlpsol("solver","sqpmethod",nlp,opts)
+      full = solver(rti_phase=0,**inputs)
+      solver = nlpsol("solver","sqpmethod",nlp,opts)
+      prep = solver(rti_phase=1,**inputs)
+      self.checkarray(prep["x"],DM(inputs["x0"]))
+      self.checkarray(prep["g"],DM(0.5))
+      res = solver(rti_phase=2,x0=[0,0],lbg=0,ubg=1)
+      for k in ["x","f","g","lam_x","lam_g"]:
+        self.checkarray(res[k],full[k])
+      with self.assertInException("rti_phase"):
+        solver(rti_phase=3,**inputs)
+
+      solver = nlpsol("solver","sqpmethod",nlp,opts)
+      self.check_codegen(solver,dict(inputs,rti_phase=0),std="c99")
+
+  def test_tangential_predictor(self):
+    x=SX.sym("x",2)
+    p=SX.sym("p")
+    nlp={'x':x, 'p':p, 'f':(x[0]-p)**2+(x[1]-p**2)**2, 'g':x[0]+x[1]}
+    opts = {"qpsol":"qrqp","print_header":False,"print_iteration":False,"print_time":False,
+            "qpsol_options":{"print_iter":False,"print_header":False,"print_info":False}}
+    args = dict(x0=0,lbx=[-10,-10],ubx=[10,0.6],lbg=0,ubg=1.5)
+
+    solver = nlpsol("solver","sqpmethod",nlp,dict(opts,tangential_predictor=True))
+    with self.assertInException("No KKT factorization"):
+      nlpsol_predictor("pred",solver)(p=1)
+    sol = solver(p=1,**args)
+    pred = nlpsol_predictor("pred",solver)
+
+    # Unchanged data reproduces the solution
+    res = pred(p=1,lbx=args["lbx"],ubx=args["ubx"],lbg=0,ubg=1.5)
+    self.checkarray(res["x"],sol["x"],digits=10)
+    self.checkarray(res["lam_g"],sol["lam_g"],digits=10)
+
+    # First-order agreement with the forward sensitivities
+    dp = 1e-3
+    res = pred(p=1+dp,lbx=args["lbx"],ubx=args["ubx"],lbg=0,ubg=1.5)
+    ref = nlpsol("solver","sqpmethod",nlp,opts)(p=1+dp,**args)
+    self.checkarray(res["x"],ref["x"],digits=5)
+    self.checkarray(res["lam_x"],ref["lam_x"],digits=5)
+    self.checkarray(res["lam_g"],ref["lam_g"],digits=5)
+
+  def test_multistart(self):
+    x=SX.sym("x")
+    nlp={'x':x, 'f':sin(3*x)+0.1*x**2}
+    args = dict(x0=2,lbx=-3,ubx=3)
+
+    opts = {"qpsol":"qrqp","print_header":False,"print_iteration":False,"print_time":False,
+            "qpsol_options":{"print_iter":False,"print_header":False,"print_info":False}}
+    ref = nlpsol("solver","sqpmethod",nlp,opts)(**args)
+    solver = nlpsol("solver","multistart",nlp,{"nlpsol":"sqpmethod","nlpsol_options":opts,
+                                               "n_starts":8,"num_threads":2})
+    res = solver(**args)
+    self.checkarray(res["x"],DM(-0.512214),digits=5)
+    self.assertTrue(float(res["f"])<float(ref["f"]))
+    stats = solver.stats()
+    self.assertTrue(stats["success"])
+    self.assertEqual(len(stats["starts"]),8)
+    self.assertEqual(stats["ranking"][0],stats["best_start"])
+
+    # Stop early once the objective target is reached
+    solver = nlpsol("solver","multistart",nlp,{"nlpsol":"sqpmethod","nlpsol_options":opts,
+                                               "n_starts":8,"starts":[[-0.5]],
+                                               "objective_target":-0.9})
+    res = solver(**args)
+    self.assertTrue(float(res["f"])<=-0.9)
+    self.assertEqual(len(solver.stats()["starts"]),2)
+
+  def test_hessian_edge_pushing(self):
+    x=SX.sym("x",4)
+    p=SX.sym("p")
+    f = sin(x[0]*x[1]) + exp(x[2])*x[0] + x[2]/x[3] + p*log(x[3]) + atan2(x[0],x[3]) + x[1]**2 + fmax(x[0],x[1])*x[2]
+    g = vertcat(x[0]*x[2]-p, cos(x[1])+x[3]**3, x[2]+x[3])
+    nlp={'x':x, 'p':p, 'f':f, 'g':g}
+    args = [[0.3,0.7,-0.4,0.9],0.5,1.3,[0.2,-0.7,1.1]]
+
+    opts = {"qpsol":"qrqp","print_header":False,"print_iteration":False,"print_time":False,
+            "qpsol_options":{"print_iter":False,"print_header":False,"print_info":False}}
+    ref = nlpsol("solver","sqpmethod",nlp,opts).get_function("nlp_hess_l")
+    opts["hessian_method"] = "edge_pushing"
+    solver = nlpsol("solver","sqpmethod",nlp,opts)
+    H = solver.get_function("nlp_hess_l")
+    self.assertTrue(H.sparsity_out(0)==ref.sparsity_out(0))
+    self.checkarray(H(*args),ref(*args),digits=12)
+    H = Function.deserialize(H.serialize())
+    self.checkarray(H(*args),ref(*args),digits=12)
+    with self.assertInException("edge_pushing"):
+      solver.generate("edge_pushing_gen.c")
+
+  def test_sqpmethod_ls_batch(self):
+    x=SX.sym("x")
+    y=SX.sym("y")
+    nlp={'x':vertcat(x,y), 'f':100*(y-x**2)**2+(1-x)**2, 'g':x+y}
+    args = dict(x0=[-1.2,1],lbg=-10,ubg=10)
+
+    opts = {"qpsol":"qrqp","print_header":False,"print_iteration":False,"print_time":False,
+            "max_iter_ls":8,"qpsol_options":{"print_iter":False,"print_header":False,"print_info":False}}
+    solver = nlpsol("solver","sqpmethod",nlp,opts)
+    ref = solver(**args)
+    ref_iter = solver.stats()["iter_count"]
+    for ls_batch in [2,4]:
+      opts["ls_batch"] = ls_batch
+      solver = nlpsol("solver","sqpmethod",nlp,opts)
+      res = solver(**args)
+      self.assertEqual(solver.stats()["iter_count"],ref_iter)
+      self.assertTrue(solver.stats()["n_call_nlp_fg_batch"]>0)
+      self.checkarray(res["x"],ref["x"],digits=10)
+
+  @requires_nlpsol("ipopt")
+  def test_ipopt_fused_oracle(self):
+    x=SX.sym("x")
+    y=SX.sym("y")
+    nlp={'x':vertcat(x,y), 'f':(1-x)**2+100*(y-x**2)**2, 'g':x**2+y**2}
+    args = dict(x0=[0.5,0.5],lbx=-10,ubx=10,lbg=0,ubg=1)
+
+    ref = nlpsol("solver","ipopt",nlp)(**args)
+    solver = nlpsol("solver","ipopt",nlp,{"fused_oracle":True})
+    res = solver(**args)
+    self.checkarray(res["x"],ref["x"],digits=8)
+    self.checkarray(res["lam_g"],ref["lam_g"],digits=8)
+    stats = solver.stats()
+    self.assertTrue(stats["n_call_nlp_fused"]>0)
+    self.assertFalse("n_call_nlp_jac_g" in stats and stats["n_call_nlp_jac_g"]>0)
+
   def test_warmstart(self):
 
     x=SX.sym("x")